@@ -3,9 +3,42 @@
 #include <chrono>
 #include <string>
 #include <random>
+#include <array>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <functional>
 
 std::mt19937 generator{std::random_device{}()};
 
+// Count every allocation made through the global operator new to report memory usage
+static std::size_t allocated_bytes = 0;
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+	allocated_bytes += size;
+	++allocation_count;
+	
+	if (auto const memory = std::malloc(size == 0 ? 1 : size)) {
+		return memory;
+	}
+	
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
 template<std::size_t nth, std::size_t size>
 struct Service1 {
 	constexpr Service1() = default;
@@ -76,15 +109,46 @@ BENCHMARK_TEMPLATE(service_bench, 32, 16);
 BENCHMARK_TEMPLATE(service_bench, 64, 16);
 BENCHMARK_TEMPLATE(service_bench, 128, 16);
 
+template<std::size_t size, std::size_t... S>
+static void service_all_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	for (auto _ : state) {
+		kgr::container container;
+		benchmark::DoNotOptimize(container.service_all<Definition1<S, size>...>());
+	}
+}
+
+template<std::size_t amount, std::size_t size>
+static void service_all_bench(benchmark::State& state) {
+	service_all_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(service_all_bench, 8, 8);
+BENCHMARK_TEMPLATE(service_all_bench, 32, 8);
+BENCHMARK_TEMPLATE(service_all_bench, 128, 8);
+BENCHMARK_TEMPLATE(service_all_bench, 128, 16);
+
 template<std::size_t size, std::size_t... S>
 static void emplace_bench(kgr::detail::seq<S...>, benchmark::State& state) {
 	using unpack = int[];
+	std::size_t bytes = 0;
+	std::size_t allocations = 0;
+	
 	for (auto _ : state) {
+		auto const bytes_before = allocated_bytes;
+		auto const allocations_before = allocation_count;
+		
 		kgr::container container;
 		(void) unpack{(
 			container.emplace<Definition1<S, size>>()
 		, 0)...};
+		
+		bytes += allocated_bytes - bytes_before;
+		allocations += allocation_count - allocations_before;
 	}
+	
+	auto const services = static_cast<double>(state.iterations() * sizeof...(S));
+	state.counters["bytes_per_service"] = static_cast<double>(bytes) / services;
+	state.counters["allocs_per_service"] = static_cast<double>(allocations) / services;
 }
 
 template<std::size_t amount, std::size_t size>
@@ -110,6 +174,215 @@ BENCHMARK_TEMPLATE(emplace_bench, 32, 16);
 BENCHMARK_TEMPLATE(emplace_bench, 64, 16);
 BENCHMARK_TEMPLATE(emplace_bench, 128, 16);
 
+BENCHMARK_TEMPLATE(emplace_bench, 256, 1);
+BENCHMARK_TEMPLATE(emplace_bench, 256, 16);
+
+template<std::size_t size, std::size_t... S>
+static void emplace_all_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	std::size_t bytes = 0;
+	std::size_t allocations = 0;
+	
+	for (auto _ : state) {
+		auto const bytes_before = allocated_bytes;
+		auto const allocations_before = allocation_count;
+		
+		kgr::container container;
+		container.emplace_all<Definition1<S, size>...>();
+		
+		bytes += allocated_bytes - bytes_before;
+		allocations += allocation_count - allocations_before;
+	}
+	
+	auto const services = static_cast<double>(state.iterations() * sizeof...(S));
+	state.counters["bytes_per_service"] = static_cast<double>(bytes) / services;
+	state.counters["allocs_per_service"] = static_cast<double>(allocations) / services;
+}
+
+template<std::size_t amount, std::size_t size>
+static void emplace_all_bench(benchmark::State& state) {
+	emplace_all_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(emplace_all_bench, 8, 8);
+BENCHMARK_TEMPLATE(emplace_all_bench, 32, 8);
+BENCHMARK_TEMPLATE(emplace_all_bench, 128, 8);
+BENCHMARK_TEMPLATE(emplace_all_bench, 256, 1);
+BENCHMARK_TEMPLATE(emplace_all_bench, 256, 16);
+
+template<std::size_t... S>
+static void type_id_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(kgr::type_id<Definition1<S, 1>>())
+		, 0)...};
+	}
+}
+
+template<std::size_t amount>
+static void type_id_bench(benchmark::State& state) {
+	type_id_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(type_id_bench, 8);
+BENCHMARK_TEMPLATE(type_id_bench, 64);
+
+template<std::size_t... S>
+static void service_table_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::detail::service_table table;
+	kgr::type_id_t const ids[] = {kgr::type_id<Definition1<S, 1>>()...};
+	
+	for (auto const id : ids) {
+		table.emplace(id, kgr::detail::service_storage{});
+	}
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(table.find(ids[S]))
+		, 0)...};
+	}
+	
+	state.counters["table_bytes_per_service"] = static_cast<double>(table.memory_usage()) / static_cast<double>(sizeof...(S));
+}
+
+template<std::size_t amount>
+static void service_table_bench(benchmark::State& state) {
+	service_table_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(service_table_bench, 8);
+BENCHMARK_TEMPLATE(service_table_bench, 16);
+BENCHMARK_TEMPLATE(service_table_bench, 24);
+BENCHMARK_TEMPLATE(service_table_bench, 48);
+BENCHMARK_TEMPLATE(service_table_bench, 96);
+BENCHMARK_TEMPLATE(service_table_bench, 128);
+BENCHMARK_TEMPLATE(service_table_bench, 192);
+BENCHMARK_TEMPLATE(service_table_bench, 1024);
+
+template<std::size_t... S>
+static void key_scan_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::type_id_t const ids[] = {kgr::type_id<Definition1<S, 1>>()...};
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(kgr::detail::find_key(ids, sizeof...(S), ids[S]))
+		, 0)...};
+	}
+}
+
+template<std::size_t amount>
+static void key_scan_bench(benchmark::State& state) {
+	key_scan_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(key_scan_bench, 8);
+BENCHMARK_TEMPLATE(key_scan_bench, 16);
+BENCHMARK_TEMPLATE(key_scan_bench, 24);
+BENCHMARK_TEMPLATE(key_scan_bench, 48);
+BENCHMARK_TEMPLATE(key_scan_bench, 96);
+BENCHMARK_TEMPLATE(key_scan_bench, 128);
+
+template<std::size_t... S>
+static void frozen_table_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::detail::service_table services;
+	kgr::type_id_t const ids[] = {kgr::type_id<Definition1<S, 1>>()...};
+	
+	for (auto const id : ids) {
+		services.emplace(id, kgr::detail::service_storage{});
+	}
+	
+	kgr::detail::frozen_service_table const table{services};
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(table.find(ids[S]))
+		, 0)...};
+	}
+	
+	state.counters["table_bytes_per_service"] = static_cast<double>(table.memory_usage()) / static_cast<double>(sizeof...(S));
+}
+
+template<std::size_t amount>
+static void frozen_table_bench(benchmark::State& state) {
+	frozen_table_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(frozen_table_bench, 8);
+BENCHMARK_TEMPLATE(frozen_table_bench, 24);
+BENCHMARK_TEMPLATE(frozen_table_bench, 48);
+BENCHMARK_TEMPLATE(frozen_table_bench, 96);
+BENCHMARK_TEMPLATE(frozen_table_bench, 192);
+BENCHMARK_TEMPLATE(frozen_table_bench, 1024);
+
+template<std::size_t... S>
+static void dynamic_lookup_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	container.emplace_all<Definition1<S, 1>...>();
+	
+	for (auto _ : state) {
+		auto fork = container.fork();
+		(void) unpack{(
+			benchmark::DoNotOptimize(&fork.service<Definition1<S, 1>>())
+		, 0)...};
+	}
+}
+
+template<std::size_t amount>
+static void dynamic_lookup_bench(benchmark::State& state) {
+	dynamic_lookup_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(dynamic_lookup_bench, 8);
+BENCHMARK_TEMPLATE(dynamic_lookup_bench, 64);
+BENCHMARK_TEMPLATE(dynamic_lookup_bench, 256);
+
+template<std::size_t... S>
+static void frozen_lookup_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	container.emplace_all<Definition1<S, 1>...>();
+	
+	auto frozen = container.freeze();
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(&frozen.service<Definition1<S, 1>>())
+		, 0)...};
+	}
+}
+
+template<std::size_t amount>
+static void frozen_lookup_bench(benchmark::State& state) {
+	frozen_lookup_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(frozen_lookup_bench, 8);
+BENCHMARK_TEMPLATE(frozen_lookup_bench, 64);
+BENCHMARK_TEMPLATE(frozen_lookup_bench, 256);
+
+template<std::size_t... S>
+static void freeze_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	kgr::container container;
+	container.emplace_all<Definition1<S, 1>...>();
+	
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(container.freeze());
+	}
+}
+
+template<std::size_t amount>
+static void freeze_bench(benchmark::State& state) {
+	freeze_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(freeze_bench, 8);
+BENCHMARK_TEMPLATE(freeze_bench, 256);
+
 template<std::size_t size, std::size_t... S>
 static void service_half_insert_bench(kgr::detail::seq<S...>, benchmark::State& state) {
 	using unpack = int[];
@@ -241,23 +514,23 @@ static void service_read_bench(benchmark::State& state) {
 	service_read_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
 }
 
-BENCHMARK_TEMPLATE(service_read_bench, 8, 8);
-BENCHMARK_TEMPLATE(service_read_bench, 16, 8);
-BENCHMARK_TEMPLATE(service_read_bench, 32, 8);
-BENCHMARK_TEMPLATE(service_read_bench, 64, 8);
-BENCHMARK_TEMPLATE(service_read_bench, 128, 8);
+BENCHMARK_TEMPLATE(service_read_bench, 8, 8)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 16, 8)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 32, 8)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 64, 8)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 128, 8)->UseManualTime();
 
-BENCHMARK_TEMPLATE(service_read_bench, 8, 16);
-BENCHMARK_TEMPLATE(service_read_bench, 16, 16);
-BENCHMARK_TEMPLATE(service_read_bench, 32, 16);
-BENCHMARK_TEMPLATE(service_read_bench, 64, 16);
-BENCHMARK_TEMPLATE(service_read_bench, 128, 16);
+BENCHMARK_TEMPLATE(service_read_bench, 8, 16)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 16, 16)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 32, 16)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 64, 16)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 128, 16)->UseManualTime();
 
-BENCHMARK_TEMPLATE(service_read_bench, 8, 128);
-BENCHMARK_TEMPLATE(service_read_bench, 16, 128);
-BENCHMARK_TEMPLATE(service_read_bench, 32, 128);
-BENCHMARK_TEMPLATE(service_read_bench, 64, 128);
-BENCHMARK_TEMPLATE(service_read_bench, 128, 128);
+BENCHMARK_TEMPLATE(service_read_bench, 8, 128)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 16, 128)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 32, 128)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 64, 128)->UseManualTime();
+BENCHMARK_TEMPLATE(service_read_bench, 128, 128)->UseManualTime();
 
 constexpr auto distribute(std::size_t nth, std::size_t iteration_count, std::size_t total_size) -> std::size_t {
 	return iteration_count == total_size ? nth : ((nth) * (total_size / iteration_count) + (total_size / (iteration_count * 2)));
@@ -344,4 +617,585 @@ BENCHMARK_TEMPLATE(service_inserted_bench, 32, 16, 16);
 BENCHMARK_TEMPLATE(service_inserted_bench, 64, 16, 16);
 BENCHMARK_TEMPLATE(service_inserted_bench, 128, 16, 16);
 
+template<std::size_t size, std::size_t... S>
+static void service_hot_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(
+		void(container.service<Definition1<S, size>>())
+	, 0)...};
+	
+	// Only the last service is asked repeatedly, the others only make the container larger
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&container.service<Definition1<sizeof...(S) - 1, size>>());
+	}
+}
+
+template<std::size_t amount, std::size_t size>
+static void service_hot_bench(benchmark::State& state) {
+	service_hot_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(service_hot_bench, 8, 8);
+BENCHMARK_TEMPLATE(service_hot_bench, 32, 8);
+BENCHMARK_TEMPLATE(service_hot_bench, 128, 8);
+
+template<std::size_t size, std::size_t... S, std::size_t... S2>
+static void static_service_inserted_bench(kgr::detail::seq<S...>, kgr::detail::seq<S2...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::static_container<Definition1<S, size>...> container;
+	
+	(void) unpack{(
+		container.template service<Definition1<S, size>>()
+	, 0)...};
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			container.template service<Definition1<distribute(S2, sizeof...(S2), sizeof...(S)), size>>()
+		, 0)...};
+	}
+}
+
+template<std::size_t amount, std::size_t size, std::size_t nb = amount>
+static void static_service_inserted_bench(benchmark::State& state) {
+	static_service_inserted_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, typename kgr::detail::seq_gen<nb>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 8, 8);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 16, 8);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 32, 8);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 64, 8);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 128, 8);
+
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 8, 8, 1);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 32, 8, 1);
+BENCHMARK_TEMPLATE(static_service_inserted_bench, 128, 8, 1);
+
+template<std::size_t size, std::size_t... S>
+static void fork_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(
+		void(container.service<Definition1<S, size>>())
+	, 0)...};
+	
+	for (auto _ : state) {
+		kgr::container fork = container.fork();
+		benchmark::DoNotOptimize(fork);
+	}
+}
+
+template<std::size_t amount, std::size_t size>
+static void fork_bench(benchmark::State& state) {
+	fork_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(fork_bench, 8, 8);
+BENCHMARK_TEMPLATE(fork_bench, 32, 8);
+BENCHMARK_TEMPLATE(fork_bench, 128, 8);
+BENCHMARK_TEMPLATE(fork_bench, 256, 8);
+
+template<std::size_t size, bool monotonic, std::size_t... S>
+static void fork_resource_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(
+		S % 2 ? void(container.service<Definition1<S, size>>()) : void()
+	, 0)...};
+	
+	alignas(std::max_align_t) static unsigned char buffer[64 * 1024];
+	std::size_t allocations = 0;
+	
+	for (auto _ : state) {
+		auto const allocations_before = allocation_count;
+		
+		{
+			kgr::monotonic_buffer_resource resource{buffer, sizeof(buffer)};
+			kgr::container fork = monotonic ? container.fork(resource) : container.fork();
+			
+			(void) unpack{(
+				fork.service<Definition1<S, size>>()
+			, 0)...};
+		}
+		
+		allocations += allocation_count - allocations_before;
+	}
+	
+	state.counters["allocs_per_fork"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+}
+
+template<std::size_t amount, std::size_t size, bool monotonic>
+static void fork_resource_bench(benchmark::State& state) {
+	fork_resource_bench<size, monotonic>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(fork_resource_bench, 8, 8, false);
+BENCHMARK_TEMPLATE(fork_resource_bench, 32, 8, false);
+BENCHMARK_TEMPLATE(fork_resource_bench, 128, 8, false);
+
+BENCHMARK_TEMPLATE(fork_resource_bench, 8, 8, true);
+BENCHMARK_TEMPLATE(fork_resource_bench, 32, 8, true);
+BENCHMARK_TEMPLATE(fork_resource_bench, 128, 8, true);
+
+template<std::size_t... S>
+static void fork_resolve_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	container.emplace_all<Definition1<0, 8>, Definition1<1, 8>, Definition1<2, 8>, Definition1<3, 8>>();
+	
+	std::size_t allocations = 0;
+	
+	for (auto _ : state) {
+		auto const allocations_before = allocation_count;
+		
+		{
+			auto fork = container.fork();
+			
+			benchmark::DoNotOptimize(&fork.service<Definition1<0, 8>>());
+			benchmark::DoNotOptimize(&fork.service<Definition1<3, 8>>());
+			
+			(void) unpack{(
+				benchmark::DoNotOptimize(&fork.service<Definition1<S, 16>>())
+			, 0)..., 0};
+		}
+		
+		allocations += allocation_count - allocations_before;
+	}
+	
+	state.counters["allocs_per_fork"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+}
+
+template<std::size_t local>
+static void fork_resolve_bench(benchmark::State& state) {
+	fork_resolve_bench(typename kgr::detail::seq_gen<local>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(fork_resolve_bench, 0);
+BENCHMARK_TEMPLATE(fork_resolve_bench, 2);
+BENCHMARK_TEMPLATE(fork_resolve_bench, 8);
+BENCHMARK_TEMPLATE(fork_resolve_bench, 16);
+
+enum struct merge_mode { copy, chain, chain_compact };
+
+template<std::size_t module, std::size_t services, std::size_t... S>
+static auto load_module(kgr::detail::seq<S...>) -> kgr::container {
+	kgr::container container;
+	container.emplace_all<Definition1<module * services + S, 1>...>();
+	return container;
+}
+
+template<std::size_t services, std::size_t... M>
+static auto load_modules(kgr::detail::seq<M...>) -> std::vector<kgr::container> {
+	using unpack = int[];
+	
+	std::vector<kgr::container> modules;
+	(void) unpack{(modules.push_back(load_module<M, services>(typename kgr::detail::seq_gen<services>::type{})), 0)...};
+	
+	return modules;
+}
+
+template<merge_mode mode>
+static auto merge_modules(std::vector<kgr::container>& modules) -> kgr::container {
+	kgr::container root;
+	
+	for (auto& module : modules) {
+		if (mode == merge_mode::copy) {
+			root.merge(std::move(module));
+		} else {
+			root.chain(std::move(module));
+		}
+	}
+	
+	if (mode == merge_mode::chain_compact) {
+		root.compact();
+	}
+	
+	return root;
+}
+
+template<merge_mode mode, std::size_t modules, std::size_t services>
+static void merge_modules_bench(benchmark::State& state) {
+	for (auto _ : state) {
+		state.PauseTiming();
+		auto loaded = load_modules<services>(typename kgr::detail::seq_gen<modules>::type{});
+		state.ResumeTiming();
+		
+		auto root = merge_modules<mode>(loaded);
+		
+		state.PauseTiming();
+		loaded.clear();
+		root.clear();
+		state.ResumeTiming();
+	}
+}
+
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::copy, 8, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain, 8, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain_compact, 8, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::copy, 32, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain, 32, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain_compact, 32, 8);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::copy, 16, 32);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain, 16, 32);
+BENCHMARK_TEMPLATE(merge_modules_bench, merge_mode::chain_compact, 16, 32);
+
+template<merge_mode mode, std::size_t services, std::size_t... M>
+static void merged_lookup_bench(kgr::detail::seq<M...>, benchmark::State& state) {
+	using unpack = int[];
+	auto loaded = load_modules<services>(kgr::detail::seq<M...>{});
+	kgr::container root = merge_modules<mode>(loaded);
+	
+	for (auto _ : state) {
+		auto fork = root.fork();
+		(void) unpack{(
+			benchmark::DoNotOptimize(&fork.service<Definition1<M * services, 1>>())
+		, 0)...};
+	}
+}
+
+template<merge_mode mode, std::size_t modules, std::size_t services>
+static void merged_lookup_bench(benchmark::State& state) {
+	merged_lookup_bench<mode, services>(typename kgr::detail::seq_gen<modules>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(merged_lookup_bench, merge_mode::copy, 32, 8);
+BENCHMARK_TEMPLATE(merged_lookup_bench, merge_mode::chain, 32, 8);
+BENCHMARK_TEMPLATE(merged_lookup_bench, merge_mode::chain_compact, 32, 8);
+
+template<std::size_t size, std::size_t... S>
+static void concurrent_service_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	
+	// Shared by every thread running this benchmark, services are constructed by the first ones to ask
+	static kgr::concurrent_container container;
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			benchmark::DoNotOptimize(&container.service<Definition1<S, size>>())
+		, 0)...};
+	}
+}
+
+template<std::size_t amount, std::size_t size>
+static void concurrent_service_bench(benchmark::State& state) {
+	concurrent_service_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(concurrent_service_bench, 8, 8)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(concurrent_service_bench, 128, 8)->ThreadRange(1, 8)->UseRealTime();
+
+template<std::size_t size, std::size_t... S>
+static void locked_service_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	
+	// The same workload as concurrent_service_bench, with a container guarded by a mutex
+	static kgr::container container;
+	static std::mutex mutex;
+	
+	for (auto _ : state) {
+		(void) unpack{(
+			[&]{
+				std::lock_guard<std::mutex> lock{mutex};
+				benchmark::DoNotOptimize(&container.service<Definition1<S, size>>());
+			}()
+		, 0)...};
+	}
+}
+
+template<std::size_t amount, std::size_t size>
+static void locked_service_bench(benchmark::State& state) {
+	locked_service_bench<size>(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(locked_service_bench, 8, 8)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(locked_service_bench, 128, 8)->ThreadRange(1, 8)->UseRealTime();
+
+struct Plugin {
+	virtual ~Plugin() = default;
+	virtual auto value() const -> long = 0;
+};
+
+template<std::size_t nth>
+struct PluginImplementation : Plugin {
+	auto value() const -> long override { return static_cast<long>(nth); }
+};
+
+struct PluginDefinition : kgr::abstract_service<Plugin> {};
+
+template<std::size_t nth>
+struct PluginImplementationDefinition : kgr::single_service<PluginImplementation<nth>>, kgr::overrides<PluginDefinition> {};
+
+template<std::size_t... S>
+static void override_range_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(container.emplace<PluginImplementationDefinition<S>>(), 0)..., 0};
+	
+	for (auto _ : state) {
+		long total = 0;
+		
+		for (Plugin& plugin : container.service<kgr::override_range_service<PluginDefinition>>()) {
+			total += plugin.value();
+		}
+		
+		benchmark::DoNotOptimize(total);
+	}
+}
+
+template<std::size_t amount>
+static void override_range_bench(benchmark::State& state) {
+	override_range_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(override_range_bench, 1);
+BENCHMARK_TEMPLATE(override_range_bench, 8);
+BENCHMARK_TEMPLATE(override_range_bench, 64);
+
+template<std::size_t... S>
+static void override_view_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(container.emplace<PluginImplementationDefinition<S>>(), 0)..., 0};
+	
+	auto const view = container.service<kgr::override_view_service<PluginDefinition>>();
+	
+	for (auto _ : state) {
+		long total = 0;
+		
+		for (std::size_t i = 0 ; i < view.size() ; ++i) {
+			total += view[i].value();
+		}
+		
+		benchmark::DoNotOptimize(total);
+	}
+}
+
+template<std::size_t amount>
+static void override_view_bench(benchmark::State& state) {
+	override_view_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(override_view_bench, 1);
+BENCHMARK_TEMPLATE(override_view_bench, 8);
+BENCHMARK_TEMPLATE(override_view_bench, 64);
+
+// Redefines forward, so the container calls it through its forward function on each lookup
+template<std::size_t nth>
+struct CustomForwardDefinition : kgr::single_service<PluginImplementation<nth>>, kgr::overrides<PluginDefinition> {
+	auto forward() -> PluginImplementation<nth>& {
+		return kgr::single_service<PluginImplementation<nth>>::forward();
+	}
+};
+
+template<typename Definition>
+static void abstract_service_bench(benchmark::State& state) {
+	kgr::container container;
+	container.emplace<Definition>();
+	
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&container.service<PluginDefinition>());
+	}
+}
+
+BENCHMARK_TEMPLATE(abstract_service_bench, PluginImplementationDefinition<0>);
+BENCHMARK_TEMPLATE(abstract_service_bench, CustomForwardDefinition<0>);
+
+struct PolymorphicPluginDefinition : kgr::single_service<PluginImplementation<0>>, kgr::polymorphic {};
+
+template<typename Definition>
+static void single_read_bench(benchmark::State& state) {
+	kgr::container container;
+	container.emplace<Definition>();
+	
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(&container.service<Definition>());
+	}
+}
+
+BENCHMARK_TEMPLATE(single_read_bench, Definition1<0, 8>);
+BENCHMARK_TEMPLATE(single_read_bench, PolymorphicPluginDefinition);
+
+template<std::size_t... S>
+static void override_insert_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	std::size_t allocations = 0;
+	
+	for (auto _ : state) {
+		auto const allocations_before = allocation_count;
+		
+		kgr::container container;
+		(void) unpack{(container.emplace<PluginImplementationDefinition<S>>(), 0)..., 0};
+		
+		allocations += allocation_count - allocations_before;
+	}
+	
+	state.counters["allocs_per_service"] = static_cast<double>(allocations) / static_cast<double>(state.iterations() * sizeof...(S));
+}
+
+template<std::size_t amount>
+static void override_insert_bench(benchmark::State& state) {
+	override_insert_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(override_insert_bench, 8);
+BENCHMARK_TEMPLATE(override_insert_bench, 64);
+
+// Stands for an expensive single, like a connection pool, that takes a millisecond to construct
+template<std::size_t nth>
+struct SlowService {
+	SlowService() {
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+};
+
+template<std::size_t nth>
+struct SlowDefinition : kgr::single_service<SlowService<nth>> {};
+
+template<typename... Slow>
+struct SlowRoot {
+	explicit SlowRoot(Slow&...) {}
+};
+
+template<typename... Definitions>
+struct SlowRootDefinition : kgr::single_service<SlowRoot<kgr::service_type<Definitions>...>, kgr::dependency<Definitions...>> {};
+
+template<std::size_t... S>
+static void slow_service_all_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	for (auto _ : state) {
+		kgr::container container;
+		benchmark::DoNotOptimize(container.service_all<SlowRootDefinition<SlowDefinition<S>...>>());
+	}
+}
+
+template<std::size_t amount>
+static void slow_service_all_bench(benchmark::State& state) {
+	slow_service_all_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(slow_service_all_bench, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(slow_service_all_bench, 32)->UseRealTime();
+
+template<std::size_t... S>
+static void slow_parallel_warmup_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	for (auto _ : state) {
+		kgr::container container;
+		std::vector<std::thread> threads;
+		
+		// Runs every task on its own thread, the warmup only gives tasks whose dependencies are ready
+		container.parallel_warmup<SlowRootDefinition<SlowDefinition<S>...>>([&](std::function<void()> task) {
+			threads.emplace_back(std::move(task));
+		});
+		
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		
+		benchmark::DoNotOptimize(container.service<SlowRootDefinition<SlowDefinition<S>...>>());
+	}
+}
+
+template<std::size_t amount>
+static void slow_parallel_warmup_bench(benchmark::State& state) {
+	slow_parallel_warmup_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(slow_parallel_warmup_bench, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(slow_parallel_warmup_bench, 32)->UseRealTime();
+
+// A fixed amount of threads taking tasks from a queue, stopped when destroyed
+struct WorkerPool {
+	explicit WorkerPool(std::size_t size) {
+		for (std::size_t i = 0 ; i < size ; ++i) {
+			workers.emplace_back([this] {
+				std::unique_lock<std::mutex> lock{mutex};
+				
+				while (true) {
+					wakeup.wait(lock, [this] { return stopped || !tasks.empty(); });
+					if (tasks.empty()) return;
+					
+					auto task = std::move(tasks.back());
+					tasks.pop_back();
+					lock.unlock();
+					task();
+					lock.lock();
+				}
+			});
+		}
+	}
+	
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			stopped = true;
+		}
+		
+		wakeup.notify_all();
+		
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+	
+	void operator()(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			tasks.push_back(std::move(task));
+		}
+		
+		wakeup.notify_one();
+	}
+	
+	std::mutex mutex;
+	std::condition_variable wakeup;
+	std::vector<std::function<void()>> tasks;
+	std::vector<std::thread> workers;
+	bool stopped = false;
+};
+
+// Stands for a handler doing tens of microseconds of computation
+static auto heavy_handle(Plugin const& plugin) -> long {
+	auto state = static_cast<unsigned long>(plugin.value()) + 1;
+	
+	for (int i = 0 ; i < 50000 ; ++i) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+	}
+	
+	return static_cast<long>(state & 0xff);
+}
+
+template<std::size_t... S>
+static void parallel_for_each_bench(kgr::detail::seq<S...>, benchmark::State& state) {
+	using unpack = int[];
+	kgr::container container;
+	
+	(void) unpack{(container.emplace<PluginImplementationDefinition<S>>(), 0)..., 0};
+	
+	// The calling thread takes chunks too
+	WorkerPool pool{static_cast<std::size_t>(state.range(0) - 1)};
+	
+	for (auto _ : state) {
+		std::atomic<long> total{0};
+		
+		kgr::parallel_for_each<PluginDefinition>(container, [&](Plugin& plugin) {
+			total += heavy_handle(plugin);
+		}, pool);
+		
+		benchmark::DoNotOptimize(total.load());
+	}
+}
+
+template<std::size_t amount>
+static void parallel_for_each_bench(benchmark::State& state) {
+	parallel_for_each_bench(typename kgr::detail::seq_gen<amount>::type{}, state);
+}
+
+BENCHMARK_TEMPLATE(parallel_for_each_bench, 32)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,281 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_CONCURRENT_CONTAINER_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_CONCURRENT_CONTAINER_HPP
+
+#include "container.hpp"
+#include "detail/concurrent_service_table.hpp"
+#include "detail/traits.hpp"
+#include "detail/utils.hpp"
+#include "detail/injected.hpp"
+#include "detail/service_storage.hpp"
+#include "detail/error.hpp"
+#include "memory_resource.hpp"
+#include "predicate.hpp"
+#include "type_id.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+
+#include "detail/define.hpp"
+
+namespace kgr {
+
+/**
+ * A container that can be used by many threads at the same time.
+ *
+ * Single services that were already constructed are found without taking any lock.
+ * Every other operation is done on an inner container while holding a lock,
+ * so a single is constructed exactly once, even when many threads ask for it at the same time.
+ * Threads only wait on that lock when the single they need was not published yet.
+ */
+struct concurrent_container {
+private:
+	template<typename Condition, typename T = int> using enable_if = detail::enable_if_t<Condition::value, T>;
+	template<typename Condition, typename T = int> using disable_if = detail::enable_if_t<!Condition::value, T>;
+	
+	using lock_t = std::lock_guard<std::mutex>;
+
+public:
+	explicit concurrent_container() : concurrent_container{container{}} {}
+	
+	/*
+	 * Constructs a container that makes all its allocations from the memory resource.
+	 * The memory resource must outlive the container, and must be usable from many threads.
+	 */
+	explicit concurrent_container(memory_resource& resource) : concurrent_container{container{resource}} {}
+	
+	/*
+	 * Constructs a concurrent container that contains the services of an existing container.
+	 * The services are published on first use.
+	 */
+	explicit concurrent_container(container&& other) :
+		_container{std::move(other)},
+		_published{_container.resource()},
+		_records{detail::resource_allocator<detail::service_storage>{_container.resource()}},
+		_polymorphic{detail::resource_allocator<type_id_t>{_container.resource()}} {}
+	
+	concurrent_container(concurrent_container const&) = delete;
+	concurrent_container& operator=(concurrent_container const&) = delete;
+	
+	/*
+	 * This function construct and save in place a service definition with the provided arguments.
+	 * The service is only constructed if it is not found.
+	 * It returns if the service has been constructed.
+	 * This function require the service to be single.
+	 */
+	template<typename T, typename... Args,
+		enable_if<detail::is_emplace_valid<T, Args...>> = 0>
+	bool emplace(Args&&... args) {
+		lock_t lock{_mutex};
+		
+		auto const emplaced = _container.emplace<T>(std::forward<Args>(args)...);
+		
+		refresh();
+		
+		return emplaced;
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	bool emplace(detail::service_error<T> = {}) = delete;
+	
+	template<typename T, typename... Args>
+	bool emplace(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) = delete;
+	
+	/*
+	 * This function returns the service given by service definition T.
+	 * Single services that are already constructed are returned without locking.
+	 * Other services are constructed while holding the lock of this container.
+	 */
+	template<typename T, typename... Args, enable_if<detail::is_service_valid<T, Args...>> = 0>
+	auto service(Args&&... args) -> service_type<T> {
+		return definition<T>(std::forward<Args>(args)...).forward();
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, typename... Args>
+	auto service(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) -> detail::sink = delete;
+	
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	auto service(detail::service_error<T> = {}) -> detail::sink = delete;
+	
+	/*
+	 * This function returns the result of the callable object of type U.
+	 * It will call the function with the sevices listed in the `Services` parameter pack.
+	 */
+	template<typename First, typename... Services, typename U, typename... Args, enable_if<detail::conjunction<
+		detail::is_service_valid<First>,
+		detail::is_service_valid<Services>...>> = 0>
+	auto invoke(U&& function, Args&&... args)
+		-> detail::call_result_t<U, service_type<First>, service_type<Services>..., Args...>
+	{
+		return std::forward<U>(function)(service<First>(), service<Services>()..., std::forward<Args>(args)...);
+	}
+	
+	/*
+	 * This function return true if the container contains the service T. Returns false otherwise.
+	 * T nust be a single service.
+	 */
+	template<typename T, detail::enable_if_t<detail::is_service<T>::value && detail::is_single<T>::value, int> = 0>
+	bool contains() const {
+		if (_published.find(type_id<T>())) {
+			return true;
+		}
+		
+		lock_t lock{_mutex};
+		
+		return _container.contains<T>();
+	}
+	
+	/*
+	 * This function fork the container into a new, non concurrent container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate type as template argument.
+	 * The default predicate is kgr::all.
+	 */
+	template<typename Predicate = all, detail::enable_if_t<std::is_default_constructible<Predicate>::value, int> = 0>
+	auto fork() const -> container {
+		return fork(Predicate{});
+	}
+	
+	/*
+	 * This function fork the container into a new, non concurrent container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate as argument.
+	 * The new container allocates from the same memory resource as this one.
+	 */
+	template<typename Predicate, disable_if<std::is_base_of<memory_resource, Predicate>> = 0>
+	auto fork(Predicate predicate) const -> container {
+		return fork(predicate, _container.resource());
+	}
+	
+	/*
+	 * This function fork the container into a new, non concurrent container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * The new container makes all its allocations from the memory resource sent as parameter.
+	 * The memory resource must outlive the new container.
+	 */
+	template<typename Predicate = all, detail::enable_if_t<std::is_default_constructible<Predicate>::value, int> = 0>
+	auto fork(memory_resource& resource) const -> container {
+		return fork(Predicate{}, resource);
+	}
+	
+	/*
+	 * This function fork the container into a new, non concurrent container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate as argument, and the memory resource the new container will allocate from.
+	 * The memory resource must outlive the new container.
+	 */
+	template<typename Predicate>
+	auto fork(Predicate predicate, memory_resource& resource) const -> container {
+		lock_t lock{_mutex};
+		
+		return _container.fork(predicate, resource);
+	}
+	
+	/*
+	 * This function returns the memory resource used by this container for all its allocations.
+	 */
+	inline auto resource() const noexcept -> memory_resource& {
+		return _container.resource();
+	}
+
+private:
+	/*
+	 * This function returns a service definition.
+	 * This version of this function finds published singles without locking,
+	 * and construct them under the lock if they are not found.
+	 */
+	template<typename T, enable_if<detail::is_single<T>> = 0>
+	auto definition() -> detail::injected_wrapper<T> {
+		if (auto const storage = _published.find(type_id<T>())) {
+			auto service = *storage;
+			return detail::injected_wrapper<T>{service};
+		}
+		
+		lock_t lock{_mutex};
+		
+		auto wrapper = _container.definition<T>();
+		
+		publish<T>();
+		refresh();
+		
+		return wrapper;
+	}
+	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function is for services that are not single, which are constructed under the lock.
+	 */
+	template<typename T, typename... Args, disable_if<detail::is_single<T>> = 0>
+	auto definition(Args&&... args) -> detail::injected_wrapper<T> {
+		lock_t lock{_mutex};
+		
+		auto wrapper = _container.definition<T>(std::forward<Args>(args)...);
+		
+		refresh();
+		
+		return wrapper;
+	}
+	
+	/*
+	 * Publishes the storage of the single T so it can be found without locking.
+	 * Polymorphic services are remembered, since inserting an override changes their storage.
+	 * The lock must be held.
+	 */
+	template<typename T>
+	void publish() {
+		auto const id = type_id<T>();
+		
+		if (!_published.find(id)) {
+			_records.push_back(*_container.source().storage(id));
+			_published.publish(id, &_records.back());
+			
+			if (detail::is_polymorphic<T>::value) {
+				_polymorphic.push_back(id);
+			}
+		}
+	}
+	
+	/*
+	 * Publishes again the polymorphic services that got overriden since they were published.
+	 * Old records are kept, since other threads may be reading them.
+	 * The lock must be held.
+	 */
+	inline void refresh() {
+		for (auto const id : _polymorphic) {
+			auto const current = _container.source().storage(id);
+			auto const published = _published.find(id);
+			
+			if (current && *current != *published) {
+				_records.push_back(*current);
+				_published.publish(id, &_records.back());
+			}
+		}
+	}
+	
+	container _container;
+	mutable std::mutex _mutex;
+	detail::concurrent_service_table _published;
+	std::deque<detail::service_storage, detail::resource_allocator<detail::service_storage>> _records;
+	std::vector<type_id_t, detail::resource_allocator<type_id_t>> _polymorphic;
+};
+
+} // namespace kgr
+
+#include "detail/undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_CONCURRENT_CONTAINER_HPP
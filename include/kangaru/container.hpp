@@ -13,11 +13,17 @@
 #include "detail/service_storage.hpp"
 #include "detail/injected.hpp"
 #include "detail/error.hpp"
+#include "detail/dependency_graph.hpp"
+#include "detail/warmup_schedule.hpp"
 #include "predicate.hpp"
+#include "memory_resource.hpp"
 
 #include <unordered_map>
 #include <memory>
 #include <type_traits>
+#include <tuple>
+#include <mutex>
+#include <vector>
 
 #include "detail/define.hpp"
 
@@ -26,6 +32,13 @@ namespace kgr {
 template<typename>
 struct filtered_fork_service;
 
+struct concurrent_container;
+
+struct frozen_container;
+
+template<typename...>
+struct static_container;
+
 /**
  * The kangaru container class.
  * 
@@ -59,6 +72,13 @@ private:
 	
 public:
 	explicit container() = default;
+	
+	/*
+	 * Constructs a container that makes all its allocations from the memory resource.
+	 * The memory resource must outlive the container.
+	 */
+	explicit container(memory_resource& resource) : default_source{resource} {}
+	
 	container(container const&) = delete;
 	container& operator=(container const&) = delete;
 	container(container&&) = default;
@@ -101,6 +121,22 @@ public:
 		autocall(static_unwrap_single<T>(make_service_instance<T>(std::forward<Args>(args)...)));
 	}
 	
+	/*
+	 * This function construct and save in place every service definitions in Ts that are not found.
+	 * Memory for all of them is reserved at once, then they are emplaced in order.
+	 * It returns how many services has been constructed.
+	 * This function require the services to be single.
+	 */
+	template<typename... Ts, enable_if<detail::conjunction<detail::is_emplace_valid<Ts>...>> = 0>
+	auto emplace_all() -> std::size_t {
+		std::size_t emplaced = 0;
+		
+		source().reserve<Ts...>();
+		(void) unpack{(emplaced += emplace<Ts>() ? 1 : 0, 0)..., 0};
+		
+		return emplaced;
+	}
+	
 	/*
 	 * The following two overloads are called in a case where the service is invalid,
 	 * or is called when provided arguments don't match the constructor.
@@ -133,6 +169,35 @@ public:
 	
 	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
 	auto service(detail::service_error<T> = {}) -> detail::sink = delete;
+	
+	/*
+	 * This function returns a tuple of the services given by the service definitions Ts.
+	 * Memory for the singles in Ts is reserved at once, then the services are constructed in order,
+	 * along with their dependencies.
+	 */
+	template<typename... Ts, enable_if<detail::conjunction<detail::is_service_valid<Ts>...>> = 0>
+	auto service_all() -> std::tuple<service_type<Ts>...> {
+		source().reserve<Ts...>();
+		
+		// Elements of a braced list are evaluated in order
+		return std::tuple<service_type<Ts>...>{service<Ts>()...};
+	}
+	
+	/*
+	 * This function constructs the singles in Ts and all the singles they depend on, using the executor to run them concurrently.
+	 * Dependencies are found from the construct functions and autocall functions of the services.
+	 * Each service is constructed in a fork once its dependencies are ready, then moved into this container.
+	 * Services that inject the container, like autowired ones, are constructed by the calling thread.
+	 * 
+	 * The executor is called with tasks that must be called exactly once, on any thread.
+	 * The memory resource of this container must be thread safe.
+	 * The first exception thrown by a service is rethrown once running tasks are done.
+	 */
+	template<typename... Ts, typename Executor, enable_if<detail::conjunction<detail::is_service_valid<Ts>...>> = 0>
+	void parallel_warmup(Executor&& executor) {
+		detail::warmup_schedule schedule{make_warmup_nodes(detail::dependency_closure_t<detail::meta_list<Ts...>>{})};
+		run_warmup(schedule, executor);
+	}
 
 	/*
 	 * This function returns the result of the callable object of type U.
@@ -218,16 +283,63 @@ public:
 	 * Construction of new services within the new container will not affect the original one.
 	 * The new container must exist within the lifetime of the original container.
 	 * 
-	 * It takes a predicate as argument.
+	 * It takes a predicate as argument. The predicate is kept by the new container, and is called
+	 * when a service is looked up in the services shared with this container.
+	 * The new container allocates from the same memory resource as this one.
 	 */
-	template<typename Predicate>
+	template<typename Predicate, disable_if<std::is_base_of<memory_resource, Predicate>> = 0>
 	auto fork(Predicate predicate) const -> container {
-		return container{source().fork(predicate)};
+		return fork(predicate, source().resource());
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container will have the copied state of the first container.
+	 * Construction of new services within the new container will not affect the original one.
+	 * The new container must exist within the lifetime of the original container.
+	 * 
+	 * The new container makes all its allocations from the memory resource sent as parameter.
+	 * This is useful to give a short lived fork a monotonic buffer that is released all at once.
+	 * The memory resource must outlive the new container.
+	 * 
+	 * It takes a predicate type as template argument.
+	 * The default predicate is kgr::all.
+	 */
+	template<typename Predicate = all, detail::enable_if_t<std::is_default_constructible<Predicate>::value, int> = 0>
+	auto fork(memory_resource& resource) const -> container {
+		return fork(Predicate{}, resource);
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container will have the copied state of the first container.
+	 * Construction of new services within the new container will not affect the original one.
+	 * The new container must exist within the lifetime of the original container.
+	 * 
+	 * It takes a predicate as argument, and the memory resource the new container will allocate from.
+	 * The memory resource must outlive the new container.
+	 */
+	template<typename Predicate>
+	auto fork(Predicate predicate, memory_resource& resource) const -> container {
+		return container{source().fork(predicate, resource)};
 	}
 	
+	/*
+	 * This function freezes the services of this container into a frozen container.
+	 * Services found in the frozen container are looked up with a perfect hash, and never change.
+	 * New services are constructed in a child of the frozen container, which don't affect this one.
+	 * The frozen container must exist within the lifetime of this container.
+	 * 
+	 * This function is defined in frozen_container.hpp.
+	 */
+	inline auto freeze() const -> frozen_container;
+	
 	/*
 	 * This function merges a container with another.
 	 * The receiving container will prefer it's own instances in a case of conflicts.
+	 * 
+	 * The merged instances stay in the memory allocated by the memory resource of the other container.
+	 * That memory resource must then outlive this container.
 	 */
 	inline void merge(container&& other) {
 		source().merge(std::move(other.source()));
@@ -243,6 +355,40 @@ public:
 		merge(std::move(other));
 	}
 	
+	/*
+	 * This function merges a container with another in constant time.
+	 * The services of the other container are linked as a fallback instead of being copied,
+	 * and the receiving container will prefer it's own instances in a case of conflicts.
+	 * 
+	 * Each chained container makes lookups of services not found yet go through one more layer.
+	 * Call compact once many containers were chained.
+	 * 
+	 * The merged instances stay in the memory allocated by the memory resource of the other container.
+	 * That memory resource must then outlive this container.
+	 */
+	inline void chain(container&& other) {
+		source().chain(std::move(other.source()));
+	}
+	
+	/*
+	 * This function merges a container with another in constant time.
+	 * The receiving container will prefer it's own instances in a case of conflicts.
+	 * 
+	 * This function consumes the container `other`
+	 */
+	inline void chain(container& other) {
+		chain(std::move(other));
+	}
+	
+	/*
+	 * This function flattens the services of chained containers and forked containers into this one,
+	 * so finding them don't go through layers anymore.
+	 * The containers this one was forked from must still outlive it.
+	 */
+	inline void compact() {
+		source().compact();
+	}
+	
 	
 	/**
 	 * This function will add all services form the container sent as parameter into this one.
@@ -281,6 +427,13 @@ public:
 		return source().contains<T>();
 	}
 	
+	/*
+	 * This function returns the memory resource used by this container for all its allocations.
+	 */
+	inline auto resource() const noexcept -> memory_resource& {
+		return source().resource();
+	}
+	
 private:
 	///////////////////////
 	//   new service    //
@@ -510,13 +663,24 @@ private:
 	
 	/*
 	 * This function returns a service definition.
-	 * This version of this function is specific to a container service.
+	 * This version of this function is specific to an override range service.
 	 */
-	template<typename T, enable_if<detail::is_override_range_service<T>> = 0>
+	template<typename T,
+		enable_if<detail::is_override_range_service<T>> = 0,
+		disable_if<detail::is_override_view_service<T>> = 0>
 	auto definition() -> detail::injected_wrapper<T> {
 		return detail::injected<T>{T{source().overrides<detail::override_range_service_type_t<T>>()}};
 	}
 	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function is specific to an override view service.
+	 */
+	template<typename T, enable_if<detail::is_override_view_service<T>> = 0>
+	auto definition() -> detail::injected_wrapper<T> {
+		return detail::injected<T>{T{source().override_view<detail::override_range_service_type_t<T>>()}};
+	}
+	
 	/*
 	 * This function returns a service definition.
 	 * This version of this function create the service if it was not created before.
@@ -531,6 +695,149 @@ private:
 		);
 	}
 	
+	///////////////////////
+	//      warmup       //
+	///////////////////////
+	
+	/*
+	 * A task given to the executor of a warmup, which constructs one node of the schedule.
+	 */
+	struct warmup_task {
+		container* parent;
+		detail::warmup_schedule* schedule;
+		std::size_t index;
+		
+		void operator()() const {
+			parent->warmup_forked(*schedule, index);
+		}
+	};
+	
+	template<typename... Ss>
+	static auto make_warmup_nodes(detail::meta_list<Ss...>) -> std::vector<detail::warmup_node> {
+		using closure = detail::meta_list<Ss...>;
+		return std::vector<detail::warmup_node>{
+			make_warmup_node<closure, Ss>(detail::graph_dependencies_t<closure, Ss>{})...
+		};
+	}
+	
+	template<typename Closure, typename T, typename... Dependencies>
+	static auto make_warmup_node(detail::meta_list<Dependencies...>) -> detail::warmup_node {
+		return detail::warmup_node{
+			type_id<T>(),
+			[](container& target) { target.definition<T>(); },
+			detail::is_container_dependent<T>::value,
+			std::vector<std::size_t>{detail::meta_list_find<Dependencies, Closure>::value...}
+		};
+	}
+	
+	/*
+	 * Runs the schedule until every node is constructed.
+	 * Nodes left waiting on each other in a cycle are constructed in order, as `service` would do.
+	 */
+	template<typename Executor>
+	void run_warmup(detail::warmup_schedule& schedule, Executor& executor) {
+		std::unique_lock<std::mutex> lock{schedule.mutex};
+		
+		schedule.start([this](type_id_t id) { return source().storage(id) != nullptr; });
+		
+		while (schedule.remaining > 0) {
+			if (!schedule.ready.empty() && !warmup_failed(schedule)) {
+				auto const index = schedule.take();
+				
+				if (schedule.done[index]) continue;
+				
+				if (schedule.nodes[index].sequential) {
+					warmup_sequential(schedule, index);
+				} else {
+					++schedule.in_flight;
+					lock.unlock();
+					executor(warmup_task{this, &schedule, index});
+					lock.lock();
+				}
+			} else if (schedule.in_flight > 0) {
+				schedule.finished.wait(lock);
+			} else {
+				break;
+			}
+		}
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+		if (schedule.error) {
+			std::rethrow_exception(schedule.error);
+		}
+#endif
+
+		for (std::size_t index = 0 ; index < schedule.nodes.size() ; ++index) {
+			if (!schedule.done[index]) {
+				schedule.nodes[index].construct(*this);
+			}
+		}
+	}
+	
+	/*
+	 * Constructs a node in this container while holding the lock of the schedule.
+	 */
+	void warmup_sequential(detail::warmup_schedule& schedule, std::size_t const index) {
+#ifndef KGR_KANGARU_NOEXCEPTION
+		try {
+			schedule.nodes[index].construct(*this);
+		} catch (...) {
+			schedule.error = std::current_exception();
+			return;
+		}
+#else
+		schedule.nodes[index].construct(*this);
+#endif
+
+		schedule.complete(index);
+	}
+	
+	/*
+	 * Constructs a node in a fork of this container without holding the lock, then moves the new services in this container.
+	 * The fork only reads frozen layers of this container, which are never modified.
+	 */
+	void warmup_forked(detail::warmup_schedule& schedule, std::size_t const index) {
+		std::unique_lock<std::mutex> lock{schedule.mutex};
+		auto local = fork();
+		lock.unlock();
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+		try {
+			schedule.nodes[index].construct(local);
+		} catch (...) {
+			lock.lock();
+			
+			if (!schedule.error) {
+				schedule.error = std::current_exception();
+			}
+			
+			--schedule.in_flight;
+			schedule.finished.notify_one();
+			return;
+		}
+#else
+		schedule.nodes[index].construct(local);
+#endif
+
+		lock.lock();
+		source().absorb(std::move(local.source()));
+		schedule.complete(index);
+		
+		// Notified while holding the lock, since the schedule is destroyed as soon as the warmup returns
+		--schedule.in_flight;
+		schedule.finished.notify_one();
+	}
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+	static auto warmup_failed(detail::warmup_schedule const& schedule) noexcept -> bool {
+		return static_cast<bool>(schedule.error);
+	}
+#else
+	static auto warmup_failed(detail::warmup_schedule const&) noexcept -> bool {
+		return false;
+	}
+#endif
+
 	///////////////////////
 	//      invoke       //
 	///////////////////////
@@ -603,6 +910,22 @@ private:
 	 */
 	friend auto service_map(container const&) -> container_service;
 	friend auto service_map(container&&) -> filtered_fork_service<all>;
+	
+	/*
+	 * The concurrent container drives a container while holding its lock.
+	 */
+	friend struct concurrent_container;
+	
+	/*
+	 * The frozen container reads the services of a container, and constructs new services with its child.
+	 */
+	friend struct frozen_container;
+	
+	/*
+	 * The static container constructs services with a container before keeping them in its slots.
+	 */
+	template<typename...>
+	friend struct static_container;
 };
 
 } // namespace kgr
@@ -0,0 +1,114 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DEPENDENCY_GRAPH_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DEPENDENCY_GRAPH_HPP
+
+#include "detail/dependency_graph.hpp"
+#include "detail/meta_list.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace kgr {
+
+/**
+ * The graph of the dependencies of a list of service definitions, computed at compile time.
+ *
+ * Nodes are every service needed to construct the services in `Definitions`, singles or not.
+ * They are numbered in a topological order: each service comes after the services it depends on.
+ * Dependencies are found from the construct functions, the default service of abstract services and the autocall functions.
+ *
+ * Every function is usable in constant expressions.
+ */
+template<typename... Definitions>
+struct dependency_graph {
+	/*
+	 * The services of the graph, in topological order.
+	 */
+	using services = detail::dependency_order_t<detail::meta_list<Definitions...>>;
+	
+	/*
+	 * The service of the node at the index.
+	 */
+	template<std::size_t I>
+	using service = detail::meta_list_element_t<I, services>;
+
+private:
+	template<typename T>
+	using dependency_count_of = std::integral_constant<std::size_t, detail::meta_list_size<detail::dependency_indices_t<services, T>>::value>;
+	
+	template<typename>
+	struct edges_of;
+	
+	template<typename... Services>
+	struct edges_of<detail::meta_list<Services...>> {
+		using type = detail::meta_list_concat_t<detail::dependency_indices_t<services, Services>...>;
+	};
+	
+	using edges = detail::static_values<typename edges_of<services>::type>;
+	using offsets = detail::static_values<detail::prefix_sums_t<detail::meta_list_transform_t<services, dependency_count_of>>>;
+	using depths = detail::dependency_depths_t<services>;
+	
+	template<typename>
+	struct max_depth_of;
+	
+	template<typename... Depths>
+	struct max_depth_of<detail::meta_list<Depths...>> : detail::static_max<Depths::value...> {};
+
+public:
+	/*
+	 * Returns the number of services in the graph.
+	 */
+	static constexpr auto size() noexcept -> std::size_t {
+		return detail::meta_list_size<services>::value;
+	}
+	
+	/*
+	 * Returns whether the service T is a node of the graph.
+	 */
+	template<typename T>
+	static constexpr auto contains() noexcept -> bool {
+		return detail::meta_list_contains<T, services>::value;
+	}
+	
+	/*
+	 * Returns the index of the node of the service T.
+	 */
+	template<typename T>
+	static constexpr auto index() noexcept -> std::size_t {
+		static_assert(detail::meta_list_contains<T, services>::value, "The service is not part of the dependency graph");
+		return detail::meta_list_find<T, services>::value;
+	}
+	
+	/*
+	 * Returns how many services the node depends on directly.
+	 */
+	static constexpr auto dependency_count(std::size_t const node) noexcept -> std::size_t {
+		return offsets::values[node + 1] - offsets::values[node];
+	}
+	
+	/*
+	 * Returns the index of the nth direct dependency of the node.
+	 * Dependencies have a smaller index than the node, unless they are part of a cycle.
+	 */
+	static constexpr auto dependency(std::size_t const node, std::size_t const nth) noexcept -> std::size_t {
+		return edges::values[offsets::values[node] + nth];
+	}
+	
+	/*
+	 * Returns the length of the longest chain of dependencies below the node.
+	 * A service without dependencies has a depth of zero.
+	 */
+	static constexpr auto depth(std::size_t const node) noexcept -> std::size_t {
+		return detail::static_values<depths>::values[node];
+	}
+	
+	/*
+	 * Returns the length of the longest chain of dependencies in the graph, which is its critical path.
+	 */
+	static constexpr auto max_depth() noexcept -> std::size_t {
+		return max_depth_of<depths>::value;
+	}
+};
+
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DEPENDENCY_GRAPH_HPP
@@ -0,0 +1,180 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_CONCURRENT_SERVICE_TABLE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_CONCURRENT_SERVICE_TABLE_HPP
+
+#include "service_storage.hpp"
+#include "service_table.hpp"
+
+#include "../type_id.hpp"
+#include "../memory_resource.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Hash table of published services that can be read by many threads without locking.
+ *
+ * Only one thread at a time may write into the table, and entries are never removed.
+ * The storage of an entry is published before its key with release semantics,
+ * so a reader that sees a key also sees the storage associated with it.
+ *
+ * When the table grows, the new array of slots is filled before being published.
+ * Old arrays are kept until the table is destroyed, since readers may still be probing them.
+ */
+struct concurrent_service_table {
+private:
+	struct slot {
+		std::atomic<type_id_t> key;
+		std::atomic<service_storage const*> storage;
+	};
+	
+	struct table {
+		std::size_t mask;
+		table* previous;
+		
+		auto slots() noexcept -> slot* {
+			return reinterpret_cast<slot*>(this + 1);
+		}
+		
+		auto slots() const noexcept -> slot const* {
+			return reinterpret_cast<slot const*>(this + 1);
+		}
+	};
+	
+	static_assert(sizeof(table) % alignof(slot) == 0, "Slots must be aligned when placed after the table header");
+	
+	static auto allocation_size(std::size_t const capacity) noexcept -> std::size_t {
+		return sizeof(table) + capacity * sizeof(slot);
+	}
+	
+	/*
+	 * Returns the slot containing the key, or the empty slot where it should be inserted.
+	 */
+	static auto probe(table& current, type_id_t const id) noexcept -> slot& {
+		auto index = static_cast<std::size_t>(hash_type_id(id) >> 32) & current.mask;
+		
+		while (true) {
+			auto& slot = current.slots()[index];
+			auto const stored = slot.key.load(std::memory_order_relaxed);
+			
+			if (stored == id || stored == type_id_t{}) {
+				return slot;
+			}
+			
+			index = (index + 1) & current.mask;
+		}
+	}
+	
+	auto make_table(std::size_t const capacity, table* const previous) -> table* {
+		auto const memory = _resource->allocate(allocation_size(capacity), alignof(table));
+		auto const created = ::new (memory) table{capacity - 1, previous};
+		
+		for (std::size_t i = 0 ; i < capacity ; ++i) {
+			auto const slot = ::new (created->slots() + i) concurrent_service_table::slot;
+			slot->key.store(type_id_t{}, std::memory_order_relaxed);
+			slot->storage.store(nullptr, std::memory_order_relaxed);
+		}
+		
+		return created;
+	}
+	
+	/*
+	 * Copies every entry into a table twice as large, then publishes it.
+	 */
+	auto grow(table* const current) -> table* {
+		auto const next = make_table(current ? (current->mask + 1) * 2 : std::size_t{16}, current);
+		
+		if (current) {
+			for (std::size_t i = 0 ; i <= current->mask ; ++i) {
+				auto const& slot = current->slots()[i];
+				auto const key = slot.key.load(std::memory_order_relaxed);
+				
+				if (key != type_id_t{}) {
+					auto& moved = probe(*next, key);
+					moved.storage.store(slot.storage.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					moved.key.store(key, std::memory_order_relaxed);
+				}
+			}
+		}
+		
+		_current.store(next, std::memory_order_release);
+		return next;
+	}
+
+public:
+	explicit concurrent_service_table(memory_resource& resource = new_delete_resource()) noexcept : _resource{&resource} {}
+	
+	concurrent_service_table(concurrent_service_table const&) = delete;
+	concurrent_service_table& operator=(concurrent_service_table const&) = delete;
+	
+	~concurrent_service_table() {
+		auto current = _current.load(std::memory_order_relaxed);
+		
+		while (current) {
+			auto const previous = current->previous;
+			_resource->deallocate(current, allocation_size(current->mask + 1), alignof(table));
+			current = previous;
+		}
+	}
+	
+	/*
+	 * Returns the published storage associated with the id, or null if not found.
+	 * This function can be called concurrently with any other function.
+	 */
+	auto find(type_id_t const id) const noexcept -> service_storage const* {
+		auto const current = _current.load(std::memory_order_acquire);
+		
+		if (!current) return nullptr;
+		
+		auto index = static_cast<std::size_t>(hash_type_id(id) >> 32) & current->mask;
+		
+		while (true) {
+			auto const& slot = current->slots()[index];
+			auto const stored = slot.key.load(std::memory_order_acquire);
+			
+			if (stored == id) return slot.storage.load(std::memory_order_acquire);
+			if (stored == type_id_t{}) return nullptr;
+			
+			index = (index + 1) & current->mask;
+		}
+	}
+	
+	/*
+	 * Publishes the storage for the id, replacing the one previously published if any.
+	 * The storage must stay valid for as long as the table is used.
+	 * Only one thread at a time can call this function.
+	 */
+	void publish(type_id_t const id, service_storage const* storage) {
+		auto current = _current.load(std::memory_order_relaxed);
+		
+		if (!current || (_size + 1) * 2 > current->mask + 1) {
+			current = grow(current);
+		}
+		
+		auto& slot = probe(*current, id);
+		
+		slot.storage.store(storage, std::memory_order_release);
+		
+		if (slot.key.load(std::memory_order_relaxed) != id) {
+			slot.key.store(id, std::memory_order_release);
+			++_size;
+		}
+	}
+	
+	auto size() const noexcept -> std::size_t {
+		return _size;
+	}
+
+private:
+	memory_resource* _resource;
+	std::atomic<table*> _current{nullptr};
+	std::size_t _size = 0;
+};
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_CONCURRENT_SERVICE_TABLE_HPP
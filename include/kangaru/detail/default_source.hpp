@@ -4,17 +4,22 @@
 #include "kangaru/detail/config.hpp"
 
 #include "../type_id.hpp"
+#include "../memory_resource.hpp"
+#include "../predicate.hpp"
 #include "traits.hpp"
 #include "injected.hpp"
 #include "service_storage.hpp"
+#include "service_table.hpp"
+#include "instance_arena.hpp"
+#include "service_cache.hpp"
+#include "service_layer.hpp"
 #include "override_storage_service.hpp"
 #include "service_range.hpp"
 
-#include <algorithm>
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <iterator>
+#include <algorithm>
 
 #include <string>
 #include <iostream>
@@ -27,29 +32,19 @@ namespace detail {
 /*
  * Primary storage for services in the container.
  *
+ * Services are looked up in the table of this source first, then in a chain of frozen layers.
+ * Services that were found are saved in a cache indexed by type, so finding them again don't hash.
+ * Forking freezes the table into a layer shared by both containers, which makes it O(1).
+ * Predicates of forks are applied lazily, when a lookup goes through the layer they filter.
+ *
  * Also manages override meta information.
  */
 struct default_source {
 private:
 	using alias_t = void*;
 	
-	template<typename T> using instance_ptr = std::unique_ptr<T, void(*)(alias_t) KGR_KANGARU_CXX17_NOEXCEPT>;
-	
-	using instance_cont = std::vector<instance_ptr<void>>;
-	using service_cont = std::unordered_map<type_id_t, detail::service_storage>;
-	
-	template<typename T>
-	static void deleter(alias_t i) KGR_KANGARU_CXX17_NOEXCEPT {
-		delete static_cast<T*>(i);
-	}
-	
-	template<typename T, typename... Args>
-	static instance_ptr<memory_block<T>> make_instance_ptr(Args&&... args) {
-		return instance_ptr<memory_block<T>>{
-			new memory_block<T>{std::forward<Args>(args)...},
-			&default_source::deleter<memory_block<T>>
-		};
-	}
+	using instance_cont = detail::instance_arena;
+	using service_cont = detail::service_table;
 	
 	template<typename T>
 	static inline auto evaluate_predicate(type_id_t id, T&& predicate) noexcept -> bool {
@@ -61,15 +56,10 @@ private:
 	
 	template<typename T>
 	auto emplace_or_assign(alias_t service, detail::forward_ptr<T> forward) -> detail::typed_service_storage<T> {
-		auto const it = _services.find(type_id<T>());
+		auto const& inserted = _services.insert_or_assign(type_id<T>(), detail::typed_service_storage<T>{service, forward});
+		_cache.insert(cache_index<T>(), inserted);
 		
-		if (it == _services.end()) {
-			auto inserted = _services.emplace(type_id<T>(), detail::typed_service_storage<T>{service, forward});
-			return inserted.first->second.template cast<T>();
-		} else {
-			it->second = detail::typed_service_storage<T>{service, forward};
-			return it->second.template cast<T>();
-		}
+		return inserted.template cast<T>();
 	}
 	
 	template<typename Override, typename Parent>
@@ -82,14 +72,39 @@ private:
 			"A final service cannot be overriden"
 		);
 		
-		auto inserted = emplace_or_assign<Parent>(overriden, get_override_forward<Override, Parent>());
+		auto const storage = make_forward_storage<Override, Parent>(overriden, is_forwarded_ahead<Override, Parent>{});
+		auto inserted = emplace_or_assign<Parent>(storage.service, storage.forward);
 		
-		auto& overrides = overrides_of<Parent>(get_override_storage());
-		overrides.emplace_back(type_id<Override>(), inserted);
+		auto& overrides = overrides_of<Parent>();
+		overrides.push_back(override_record{type_id<Override>(), inserted}, _instances);
 		
 		return inserted;
 	}
 	
+	/*
+	 * Polymorphic singles and overrides using the forward function of single_service are forwarded once, when inserted.
+	 * Their reference never changes, since singles are never moved.
+	 */
+	template<typename Override, typename Parent>
+	using is_forwarded_ahead = bool_constant<
+		has_single_service_forward<Override>::value && std::is_lvalue_reference<service_type<Parent>>::value
+	>;
+	
+	template<typename Override, typename Parent>
+	auto make_forward_storage(alias_t overriden, std::true_type) -> detail::typed_service_storage<Parent> {
+		auto&& forwarded = static_cast<service_type<Parent>>(static_cast<Override*>(overriden)->forward());
+		
+		return detail::typed_service_storage<Parent>{
+			const_cast<void*>(static_cast<void const volatile*>(std::addressof(forwarded))),
+			&detail::forward_reference<Parent>
+		};
+	}
+	
+	template<typename Override, typename Parent>
+	auto make_forward_storage(alias_t overriden, std::false_type) noexcept -> detail::typed_service_storage<Parent> {
+		return detail::typed_service_storage<Parent>{overriden, get_override_forward<Override, Parent>()};
+	}
+	
 	template<typename Override, typename Parent>
 	auto get_override_forward() noexcept -> detail::forward_ptr<Parent> {
 		static_assert(detail::is_polymorphic<Parent>::value,
@@ -110,40 +125,323 @@ private:
 		} : nullptr;
 	}
 	
-	inline auto get_override_storage() -> override_storage& {
-		auto it = _services.find(type_id<override_storage_service>());
+	/*
+	 * Finds a service in this source or in its layers.
+	 * The origin is set to the layer the service was found in, or null if found in this source.
+	 */
+	inline auto lookup(type_id_t const id, service_layer const*& origin) const -> service_storage const* {
+		origin = nullptr;
 		
-		if (it != _services.end()) {
-			return it->second.service<override_storage_service>().forward();
-		} else {
-			_instances.emplace_back(make_instance_ptr<override_storage_service>());
-			auto storage = emplace_or_assign<override_storage_service>(_instances.back().get(), nullptr);
-			return static_cast<override_storage_service*>(storage.service)->forward();
+		if (auto const storage = _services.find(id)) {
+			return storage;
+		}
+		
+		return find_in(_layers.get(), id, origin);
+	}
+	
+	inline auto lookup(type_id_t const id) const -> service_storage const* {
+		service_layer const* origin;
+		return lookup(id, origin);
+	}
+	
+	/*
+	 * Finds a service in a chain of layers, then in their fallbacks.
+	 * The fallbacks are only searched when every layer of the chain accepted the id.
+	 */
+	static auto find_in(service_layer const* const top, type_id_t const id, service_layer const*& origin) -> service_storage const* {
+		for (auto layer = top ; layer ; layer = layer->next.get()) {
+			if (auto const storage = layer->services.find(id)) {
+				origin = layer;
+				return storage;
+			}
+			
+			if (!layer->accepts(id)) {
+				return nullptr;
+			}
+		}
+		
+		return top && top->chained ? find_in_fallbacks(top, id, origin) : nullptr;
+	}
+	
+	/*
+	 * Searches the fallbacks of a chain, starting with the deepest one since it was merged first.
+	 */
+	static auto find_in_fallbacks(service_layer const* const layer, type_id_t const id, service_layer const*& origin) -> service_storage const* {
+		if (!layer || !layer->chained) {
+			return nullptr;
+		}
+		
+		if (auto const storage = find_in_fallbacks(layer->next.get(), id, origin)) {
+			return storage;
+		}
+		
+		return layer->fallback ? find_in(layer->fallback.get(), id, origin) : nullptr;
+	}
+	
+	/*
+	 * Returns the fallback of a chain that the layer is in, or null if it's not in any of them.
+	 */
+	static auto fallback_holding(service_layer const* const top, service_layer const* const layer) noexcept -> service_layer const* {
+		for (auto link = top ; link && link->chained ; link = link->next.get()) {
+			if (link->fallback && holds(link->fallback.get(), layer)) {
+				return link->fallback.get();
+			}
+		}
+		
+		return nullptr;
+	}
+	
+	static auto holds(service_layer const* const top, service_layer const* const layer) noexcept -> bool {
+		for (auto link = top ; link ; link = link->next.get()) {
+			if (link == layer) {
+				return true;
+			}
+		}
+		
+		return fallback_holding(top, layer) != nullptr;
+	}
+	
+	/*
+	 * Calls the function with every layer a lookup goes through before reaching the origin, as long as it returns true.
+	 * When the origin is in a fallback, the lookup went through every layer of the chain before.
+	 * Returns false if the function did.
+	 */
+	template<typename F>
+	static auto all_until(service_layer const* const top, service_layer const* const origin, F const& function) -> bool {
+		for (auto layer = top ; layer != origin ; layer = layer->next.get()) {
+			if (!layer) {
+				return all_until(fallback_holding(top, origin), origin, function);
+			}
+			
+			if (!function(*layer)) {
+				return false;
+			}
 		}
+		
+		return true;
+	}
+	
+	/*
+	 * Returns whether the filters of every layer above the origin accept the id.
+	 * A null origin is this source itself, which is never filtered.
+	 */
+	inline auto accepts_until(service_layer const* origin, type_id_t const id) const -> bool {
+		return all_until(origin ? _layers.get() : nullptr, origin, [&](service_layer const& layer) {
+			return layer.accepts(id);
+		});
+	}
+	
+	inline auto filtered_until(service_layer const* origin) const noexcept -> bool {
+		return !all_until(origin ? _layers.get() : nullptr, origin, [](service_layer const& layer) {
+			return !layer.filter;
+		});
 	}
 	
+	using filters_t = std::vector<service_layer const*, resource_allocator<service_layer const*>>;
+	
+	/*
+	 * Calls the function with every service of a chain and its fallbacks that is visible, in the order lookups search them.
+	 * A service is visible when every filter above it accepts it, and the same id was not seen before.
+	 */
+	template<typename F>
+	void for_each_in_chain(service_layer const* const top, filters_t& filters, service_table& seen, F& function) const {
+		auto const above = filters.size();
+		
+		for (auto layer = top ; layer ; layer = layer->next.get()) {
+			for (auto const& service : layer->services) {
+				auto const accepted = std::all_of(filters.begin(), filters.end(), [&](service_layer const* filtered) {
+					return filtered->accepts(service.first);
+				});
+				
+				if (accepted && !_services.contains(service.first) && seen.emplace(service.first, service_storage{}).second) {
+					function(service.first, service.second, layer);
+				}
+			}
+			
+			if (layer->filter) {
+				filters.push_back(layer);
+			}
+		}
+		
+		for_each_in_fallbacks(top, filters, seen, function);
+		filters.resize(above);
+	}
+	
+	template<typename F>
+	void for_each_in_fallbacks(service_layer const* const layer, filters_t& filters, service_table& seen, F& function) const {
+		if (layer && layer->chained) {
+			for_each_in_fallbacks(layer->next.get(), filters, seen, function);
+			
+			if (layer->fallback) {
+				for_each_in_chain(layer->fallback.get(), filters, seen, function);
+			}
+		}
+	}
+	
+	/*
+	 * Calls the function with every service visible from this source, and the layer it comes from.
+	 */
+	template<typename F>
+	void for_each_service(F function) const {
+		for (auto const& service : _services) {
+			function(service.first, service.second, static_cast<service_layer const*>(nullptr));
+		}
+		
+		if (_layers) {
+			filters_t filters{resource_allocator<service_layer const*>{resource()}};
+			service_table seen{resource()};
+			
+			for_each_in_chain(_layers.get(), filters, seen, function);
+		}
+	}
+	
+	/*
+	 * Places a new empty list of overrides in the chunks of the instances of this source.
+	 */
+	inline auto make_overrides() -> override_list& {
+		return *::new (static_cast<void*>(_instances.allocate_array<override_list>(1))) override_list{};
+	}
+	
+	/*
+	 * Places a copy of the overrides accepted by the filter with the instances of this source.
+	 */
+	template<typename F>
+	auto copy_overrides(override_list const& overrides, F filter) -> override_list& {
+		auto& copy = make_overrides();
+		copy.reserve(overrides.size(), _instances);
+		
+		for (auto const& service : overrides) {
+			if (filter(service.first)) {
+				copy.push_back(service, _instances);
+			}
+		}
+		
+		return copy;
+	}
+	
+	/*
+	 * Returns the list of overrides of T owned by this source, that can be modified.
+	 * A list inherited from a layer is copied, keeping only the overrides visible from this source.
+	 */
 	template<typename T>
-	auto overrides_of(override_storage& override_storage) -> std::vector<std::pair<type_id_t, service_storage>>& {
-		auto it = _services.find(type_id<index_storage<T>>());
+	auto overrides_of() -> override_list& {
+		auto& overrides = overrides_of(type_id<index_storage<T>>());
+		_cache.insert(cache_index<index_storage<T>>(), service_storage{override_index, static_cast<void*>(&overrides)});
 		
-		if (it != _services.end()) {
-			return override_storage.overrides[it->second.index()];
-		} else {
-			auto next_index = override_storage.overrides.size();
-			override_storage.overrides.emplace_back();
-			_services.emplace(type_id<index_storage<T>>(), service_storage{override_index, next_index});
-			return override_storage.overrides.back();
+		return overrides;
+	}
+		
+	inline auto overrides_of(type_id_t const id) -> override_list& {
+		if (auto const index = _services.find(id)) {
+			return index->template service<override_list>();
 		}
+		
+		service_layer const* origin;
+		auto const inherited = lookup(id, origin);
+		
+		auto& overrides = inherited
+			? copy_overrides(inherited->template service<override_list>(), [&](type_id_t override) { return accepts_until(origin, override); })
+			: make_overrides();
+		
+		_services.emplace(id, service_storage{override_index, static_cast<void*>(&overrides)});
+		return overrides;
 	}
 	
+	/*
+	 * Returns the list of overrides of T visible from this source, from the cache when possible.
+	 * An inherited list is only copied when a predicate filters it.
+	 */
+	template<typename T>
+	auto find_overrides() -> override_list const& {
+		auto const slot = cache_index<index_storage<T>>();
+		
+		if (auto const cached = _cache.find(slot)) {
+			return cached->template service<override_list>();
+		}
+		
+		service_layer const* origin;
+		auto const index = lookup(type_id<index_storage<T>>(), origin);
+		
+		if (index && !filtered_until(origin)) {
+			_cache.assign(slot, *index);
+			return index->template service<override_list>();
+		}
+		
+		return overrides_of<T>();
+	}
+	
+	/*
+	 * Freezes the services of this source into a new layer and returns the top layer.
+	 * The layers are flattened when they get too deep.
+	 */
+	inline auto snapshot() const -> std::shared_ptr<service_layer const> {
+		if (!_services.empty()) {
+			_layers = make_layer(std::move(_services), std::move(_layers));
+			
+			if (_layers->depth > service_layer::maximum_depth) {
+				flatten();
+			}
+		}
+		
+		return _layers;
+	}
+	
+	/*
+	 * Merges the unfiltered layers at the top of the chain into one.
+	 * A filtered layer is kept as is, since lookups must still go through its predicate.
+	 * So is a layer with a fallback, which must still be searched after the layers below it.
+	 */
+	inline void flatten() const {
+		service_table services{resource()};
+		services.reserve(_layers->services.size());
+		
+		auto link = static_cast<std::shared_ptr<service_layer const> const*>(&_layers);
+		
+		for (; *link && (*link)->flattenable() ; link = &(*link)->next) {
+			for (auto const& service : (*link)->services) {
+				services.emplace(service.first, service.second);
+			}
+		}
+		
+		auto next = *link;
+		_layers = make_layer(std::move(services), std::move(next));
+	}
+	
+	inline auto make_layer(service_table services, std::shared_ptr<service_layer const> next) const -> std::shared_ptr<service_layer const> {
+		return std::allocate_shared<service_layer>(resource_allocator<service_layer>{resource()}, std::move(services), std::move(next));
+	}
+	
+	/*
+	 * Adds what inserting the single T takes: an entry for itself and one for each parent, with their list of overrides.
+	 */
+	template<typename T, enable_if_t<is_single<T>::value, int> = 0>
+	static void add_reserved(std::size_t& services, std::size_t& instances, std::size_t& bytes, std::size_t& cache) {
+		auto const parents = meta_list_size<parent_types<T>>::value;
+		
+		auto const lists = parents + (is_polymorphic<T>::value ? 1 : 0);
+		
+		services += 1 + 2 * parents + (is_polymorphic<T>::value ? 1 : 0);
+		instances += 1;
+		bytes += sizeof(memory_block<T>) + alignof(memory_block<T>) - 1;
+		bytes += lists * (sizeof(override_list) + override_list::minimum_capacity * sizeof(override_record) + alignof(override_record));
+		cache = std::max(cache, cache_index<T>() + 1);
+	}
+	
+	template<typename T, enable_if_t<!is_single<T>::value, int> = 0>
+	static void add_reserved(std::size_t&, std::size_t&, std::size_t&, std::size_t&) noexcept {}
+	
+	/*
+	 * The storage returned always points to the definition, even when the service was forwarded ahead.
+	 */
 	template<typename T, enable_if_t<detail::is_polymorphic<T>::value, int> = 0>
 	auto insert_self(alias_t service) -> detail::typed_service_storage<T> {
-		auto inserted = emplace_or_assign<T>(service, get_forward<T>());
+		auto const storage = make_forward_storage<T, T>(service, is_forwarded_ahead<T, T>{});
+		auto inserted = emplace_or_assign<T>(storage.service, storage.forward);
 		
-		auto& overrides = overrides_of<T>(get_override_storage());
-		overrides.emplace_back(type_id<T>(), inserted);
+		auto& overrides = overrides_of<T>();
+		overrides.push_back(override_record{type_id<T>(), inserted}, _instances);
 		
-		return inserted;
+		return detail::typed_service_storage<T>{service, get_forward<T>()};
 	}
 	
 	template<typename T, enable_if_t<!detail::is_polymorphic<T>::value, int> = 0>
@@ -153,20 +451,15 @@ private:
 	
 public:
 	explicit default_source() = default;
+	
+	explicit default_source(memory_resource& resource) noexcept :
+		_instances{resource}, _services{resource}, _cache{resource} {}
+	
 	default_source(default_source const&) = delete;
 	default_source& operator=(default_source const&) = delete;
 	default_source(default_source&&) = default;
 	default_source& operator=(default_source&&) = default;
-	
-#ifdef KGR_KANGARU_REVERSE_DESTRUCTION
-	inline ~default_source() {
-		for (auto it = _instances.rbegin() ; it != _instances.rend() ; ++it) {
-			it->reset();
-		}
-	}
-#else
 	~default_source() = default;
-#endif
 	
 	/*
 	 * Adds a service in the service source
@@ -174,10 +467,7 @@ public:
 	template<typename T, typename... Parents, typename... Args>
 	auto emplace(std::false_type emplaceable, Args&&... args) -> single_insertion_result_t<T> {
 		static_cast<void>(emplaceable);
-		auto instance_ptr = make_instance_ptr<T>(std::forward<Args>(args)...);
-		auto ptr = &instance_ptr->service;
-		
-		_instances.emplace_back(std::move(instance_ptr));
+		auto ptr = &_instances.emplace<memory_block<T>>(std::forward<Args>(args)...)->service;
 		
 		return single_insertion_result_t<T>{insert_self<T>(ptr), insert_override<T, Parents>(ptr)...};
 	}
@@ -188,11 +478,7 @@ public:
 	template<typename T, typename... Parents, typename... Args>
 	auto emplace(std::true_type emplaceable, Args&&... args) -> single_insertion_result_t<T> {
 		static_cast<void>(emplaceable);
-		auto instance_ptr = make_instance_ptr<T>();
-		auto ptr = &instance_ptr->service;
-		
-		ptr->emplace(std::forward<Args>(args)...);
-		_instances.emplace_back(std::move(instance_ptr));
+		auto ptr = &_instances.emplace<memory_block<T>>(deferred_emplace, std::forward<Args>(args)...)->service;
 		
 		return single_insertion_result_t<T>{insert_self<T>(ptr), insert_override<T, Parents>(ptr)...};
 	}
@@ -202,13 +488,10 @@ public:
 	 * Every single services are invalidated after calling this function.
 	 */
 	inline void clear() noexcept {
-#ifdef KGR_KANGARU_REVERSE_DESTRUCTION
-		for (auto it = _instances.rbegin() ; it != _instances.rend() ; ++it) {
-			it->reset();
-		}
-#endif
-		_instances.clear();
+		_layers.reset();
 		_services.clear();
+		_cache.reset();
+		_instances.clear();
 	}
 	
 	/*
@@ -217,45 +500,114 @@ public:
 	 * Construction of new services within the new container will not affect the original one.
 	 * The new container must exist within the lifetime of the original container.
 	 * 
-	 * It takes a predicate as argument.
+	 * It takes a predicate as argument, and the memory resource the new container will allocate from.
 	 */
 	template<typename Predicate>
-	auto fork(Predicate predicate) const -> default_source {
-		default_source fork;
-		
-		fork._services.reserve(_services.size());
+	auto fork(Predicate predicate, memory_resource& resource) const -> default_source {
+		default_source fork{resource};
+		fork._layers = filter_layer(snapshot(), std::move(predicate), resource);
+		fork._cache.reserve(_cache.size());
+		return fork;
+	}
+	
+	/*
+	 * This function merges a container with another.
+	 * The receiving container will prefer it's own instances in a case of conflicts.
+	 * 
+	 * The instances of the other container stay in the memory given by its memory resource.
+	 */
+	inline void merge(default_source&& other) {
+		other.for_each_service([&](type_id_t id, service_storage const& storage, service_layer const* origin) {
+			if (lookup(id)) return;
 		
-		std::copy_if(
-			_services.begin(), _services.end(),
-			std::inserter(fork._services, fork._services.begin()),
-			[&predicate](service_cont::const_reference i) {
-				return evaluate_predicate(i.first, predicate);
+			if (type_id_kind(id) == service_kind_t::index_storage) {
+				auto& overrides = copy_overrides(storage.template service<override_list>(), [&](type_id_t override) {
+					return other.accepts_until(origin, override);
+				});
+				
+				_services.emplace(id, service_storage{override_index, static_cast<void*>(&overrides)});
+			} else {
+				_services.emplace(id, storage);
 			}
-		);
-		
-		auto it = _services.find(type_id<override_storage_service>());
+		});
 		
-		if (it != _services.end()) {
-			auto& this_overrides = it->second.service<override_storage_service>();
-			auto fork_overrides = std::get<0>(fork.emplace<override_storage_service>(std::false_type{}));
-			static_cast<override_storage*>(fork_overrides.service)->overrides = this_overrides.forward().filter(predicate);
+		_instances.merge(std::move(other._instances));
+		_cache.reset();
+	}
+	
+	/*
+	 * This function merges a container with another in constant time.
+	 * The services of the other container are frozen and linked as a fallback, searched after every service of this one.
+	 * The receiving container then prefers it's own instances in a case of conflicts, like with merge.
+	 * 
+	 * Each chained container adds a layer that lookups go through until compact is called.
+	 * The instances of the other container stay in the memory given by its memory resource.
+	 */
+	inline void chain(default_source&& other) {
+		if (auto fallback = other.snapshot()) {
+			_layers = std::allocate_shared<service_layer>(
+				resource_allocator<service_layer>{resource()}, service_table{resource()}, std::move(_layers), nullptr, std::move(fallback)
+			);
 		}
 		
-		return fork;
+		// Services found before are still preferred, so the cache stays valid
+		_instances.merge(std::move(other._instances));
 	}
 	
 	/*
-	 * This function merges a container with another.
-	 * The receiving container will prefer it's own instances in a case of conflicts.
+	 * Flattens the services visible from every layer into the table of this source, so lookups find them without going through layers.
+	 * Lists of overrides that come from a layer are copied, since this source may then add overrides to them.
+	 * 
+	 * The services still live in the containers this source was forked from, which must outlive it.
 	 */
-	inline void merge(default_source&& other) {
-		_services.insert(other._services.begin(), other._services.end());
-		_instances.reserve(_instances.size() + other._instances.size());
-		_instances.insert(
-			_instances.end(),
-			std::make_move_iterator(other._instances.begin()),
-			std::make_move_iterator(other._instances.end())
-		);
+	inline void compact() {
+		if (!_layers) return;
+		
+		service_table services{resource()};
+		
+		for_each_service([&](type_id_t id, service_storage const& storage, service_layer const* origin) {
+			if (origin && type_id_kind(id) == service_kind_t::index_storage) {
+				auto& overrides = copy_overrides(storage.template service<override_list>(), [&](type_id_t override) {
+					return accepts_until(origin, override);
+				});
+				
+				services.emplace(id, service_storage{override_index, static_cast<void*>(&overrides)});
+			} else {
+				services.emplace(id, storage);
+			}
+		});
+		
+		_services = std::move(services);
+		_layers.reset();
+		_cache.reset();
+	}
+	
+	/*
+	 * Moves the services inserted in another source into this one.
+	 * The other source must be a fork of this one, in which only new services were inserted.
+	 * Those services replace the ones of this source, and their overrides are added to the lists of this source.
+	 */
+	inline void absorb(default_source&& other) {
+		for (auto const& service : other._services) {
+			if (type_id_kind(service.first) == service_kind_t::index_storage) {
+				auto& overrides = overrides_of(service.first);
+				
+				for (auto const& entry : service.second.template service<override_list>()) {
+					auto const found = std::find_if(overrides.begin(), overrides.end(), [&](override_list::value_type const& existing) {
+						return existing.first == entry.first;
+					});
+					
+					if (found == overrides.end()) {
+						overrides.push_back(entry, _instances);
+					}
+				}
+			} else {
+				_services.insert_or_assign(service.first, service.second);
+			}
+		}
+		
+		_instances.merge(std::move(other._instances));
+		_cache.reset();
 	}
 	
 	/**
@@ -267,13 +619,21 @@ public:
 	 */
 	template<typename Predicate>
 	void rebase(const default_source& other, Predicate predicate) {
-		std::copy_if(
-			other._services.begin(), other._services.end(),
-			std::inserter(_services, _services.end()),
-			[&predicate](service_cont::const_reference i) {
-				return evaluate_predicate(i.first, predicate);
+		other.for_each_service([&](type_id_t id, service_storage const& storage, service_layer const* origin) {
+			if (!evaluate_predicate(id, predicate) || lookup(id)) return;
+		
+			if (type_id_kind(id) == service_kind_t::index_storage) {
+				auto& overrides = copy_overrides(storage.template service<override_list>(), [&](type_id_t override) {
+					return other.accepts_until(origin, override) && predicate(override);
+				});
+				
+				_services.emplace(id, service_storage{override_index, static_cast<void*>(&overrides)});
+			} else {
+				_services.emplace(id, storage);
 			}
-		);
+		});
+		
+		_cache.reset();
 	}
 	
 	/**
@@ -283,36 +643,132 @@ public:
 	 */
 	template<typename T, typename F1, typename F2, typename R1 = call_result_t<F1, detail::injected_wrapper<T>>, typename R2 = call_result_t<F2>>
 	auto find(F1 found, F2 fails) noexcept(noexcept(fails()) && noexcept(found(std::declval<detail::injected_wrapper<T>>()))) -> enable_if_t<std::is_same<R1, R2>::value, R1> {
-		auto it = _services.find(type_id<T>());
+		auto const index = cache_index<T>();
+		
+		if (auto const cached = _cache.find(index)) {
+			auto service = *cached;
+			return found(detail::injected_wrapper<T>{service});
+		}
+		
+		auto const storage = lookup(type_id<T>());
 		
-		if (it != _services.end()) {
-			return found(detail::injected_wrapper<T>{it->second});
+		if (storage) {
+			_cache.assign(index, *storage);
+			auto service = *storage;
+			return found(detail::injected_wrapper<T>{service});
 		} else {
 			return fails();
 		}
 	}
 	
+	/*
+	 * Returns the range of every overrides of T visible from this source.
+	 */
 	template<typename T>
 	auto overrides() -> override_range<override_iterator<T>> {
-		auto& overrides = overrides_of<T>(get_override_storage());
+		auto const& overrides = find_overrides<T>();
+		
 		return override_range<override_iterator<T>>{
 			override_iterator<T>{overrides.begin()},
 			override_iterator<T>{overrides.end()}
 		};
 	}
 	
+	/*
+	 * Returns a view of every overrides of T visible from this source, allocated from the memory resource.
+	 */
+	template<typename T>
+	auto override_view() -> kgr::override_view<T> {
+		return kgr::override_view<T>{find_overrides<T>(), resource()};
+	}
+	
 	/*
 	 * This function return true if the container contains the service T. Returns false otherwise.
 	 * T nust be a single service.
 	 */
 	template<typename T>
-	bool contains() const noexcept {
-		return _services.find(type_id<T>()) != _services.end();
+	bool contains() const {
+		return _cache.find(cache_index<T>()) || lookup(type_id<T>()) != nullptr;
+	}
+	
+	/*
+	 * Reserves memory for the singles in Ts, so they can be inserted without growing the table, the cache or the instances.
+	 * Services that are not single don't take any memory in the source.
+	 */
+	template<typename... Ts>
+	void reserve() {
+		using unpack = int[];
+		std::size_t services = 0, instances = 0, bytes = 0, cache = _cache.size();
+		
+		(void) unpack{(add_reserved<Ts>(services, instances, bytes, cache), 0)..., 0};
+		
+		_services.reserve(_services.size() + services);
+		_instances.reserve(instances, bytes);
+		_cache.reserve(cache);
+	}
+	
+	/*
+	 * Returns the storage of the service visible from this source, or null if not found.
+	 * The returned pointer is invalidated when a service is inserted in this source.
+	 */
+	inline auto storage(type_id_t const id) const -> service_storage const* {
+		return lookup(id);
+	}
+	
+	/*
+	 * Returns whether the service is stored in this source itself, rather than in one of its layers.
+	 */
+	inline auto owns(type_id_t const id) const noexcept -> bool {
+		return _services.contains(id);
+	}
+	
+	/*
+	 * Calls the function with the id and the storage of every service visible from this source.
+	 * Lists of overrides filtered by a fork are copied first, so they only contain the visible overrides.
+	 */
+	template<typename F>
+	void for_each_visible(F function) {
+		for_each_service([&](type_id_t id, service_storage const& storage, service_layer const* origin) {
+			if (type_id_kind(id) == service_kind_t::index_storage && filtered_until(origin)) {
+				auto& overrides = copy_overrides(storage.template service<override_list>(), [&](type_id_t override) {
+					return accepts_until(origin, override);
+				});
+				
+				function(id, service_storage{override_index, static_cast<void*>(&overrides)});
+			} else {
+				function(id, storage);
+			}
+		});
 	}
 	
+	/*
+	 * Returns the memory resource used by this source for all its allocations.
+	 */
+	auto resource() const noexcept -> memory_resource& {
+		return _instances.resource();
+	}
+
 private:
+	template<typename Predicate>
+	static auto filter_layer(std::shared_ptr<service_layer const> layer, Predicate predicate, memory_resource& resource) -> std::shared_ptr<service_layer const> {
+		return std::allocate_shared<filtered_service_layer<Predicate>>(
+			resource_allocator<filtered_service_layer<Predicate>>{resource}, resource, std::move(layer), std::move(predicate)
+		);
+	}
+	
+	// Forking without a predicate shares the layers as is
+	static auto filter_layer(std::shared_ptr<service_layer const> layer, all, memory_resource&) noexcept -> std::shared_ptr<service_layer const> {
+		return layer;
+	}
+	
 	instance_cont _instances;
-	service_cont _services;
+	
+	// Forking a const source freezes its services into a layer, without changing what it contains
+	mutable service_cont _services;
+	mutable std::shared_ptr<service_layer const> _layers;
+	
+	// Copies of the storage of services already found, see service_cache
+	service_cache _cache;
 };
 
 } // namespace detail
@@ -90,4 +90,15 @@
 #endif
 #endif // KGR_KANGARU_HASH_EXTENDED_CONSTEXPR
 
+#ifndef KGR_KANGARU_NO_SIMD
+// Small tables of services compare several 64 bit keys at once when the target has vector instructions.
+#if defined(__AVX2__) && (defined(__x86_64__) || defined(_M_X64))
+#define KGR_KANGARU_KEY_SCAN_AVX2
+#elif (defined(__SSE2__) && defined(__x86_64__)) || (defined(_M_X64) && !defined(_M_ARM64EC))
+#define KGR_KANGARU_KEY_SCAN_SSE2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define KGR_KANGARU_KEY_SCAN_NEON
+#endif
+#endif // KGR_KANGARU_NO_SIMD
+
 #endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_DEFINE
@@ -0,0 +1,315 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_DEPENDENCY_GRAPH_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_DEPENDENCY_GRAPH_HPP
+
+#include "meta_list.hpp"
+#include "traits.hpp"
+#include "utils.hpp"
+#include "single.hpp"
+#include "injected.hpp"
+#include "function_traits.hpp"
+#include "construct_function.hpp"
+#include "container_service.hpp"
+#include "autocall_traits.hpp"
+
+namespace kgr {
+namespace detail {
+
+/*
+ * This trait returns the concatenation of a list of lists.
+ */
+template<typename>
+struct dependency_join;
+
+template<typename... Lists>
+struct dependency_join<meta_list<Lists...>> : meta_list_concat<Lists...> {};
+
+template<typename Lists>
+using dependency_join_t = typename dependency_join<Lists>::type;
+
+/*
+ * Returns a list containing the service injected by a construct argument, or an empty list if the argument is not injected.
+ */
+template<typename Argument>
+using injected_dependency_t = conditional_t<
+	is_detected<injected_service_t, Argument>::value,
+	meta_list<detected_t<injected_service_t, Argument>>,
+	meta_list<>
+>;
+
+/*
+ * The services injected in the construct function of T.
+ */
+template<typename T>
+using construct_dependencies_t = dependency_join_t<meta_list_transform_t<
+	detected_or<meta_list<>, function_arguments_t, detected_t<construct_function_t, T>>,
+	injected_dependency_t
+>>;
+
+template<typename T>
+using default_dependency_t = meta_list<default_type<T>>;
+
+/*
+ * The services injected in the autocall functions of T.
+ */
+template<typename T>
+struct autocall_dependencies {
+private:
+	template<typename F>
+	using entry = detected_or<meta_list<>, autocall_services, T, F>;
+
+public:
+	using type = dependency_join_t<meta_list_transform_t<detected_or<meta_list<>, autocall_functions_t, T>, entry>>;
+};
+
+/*
+ * Every service T needs to be constructed: the ones injected in construct, the default service of an abstract service,
+ * and the ones injected in autocall functions.
+ */
+template<typename T>
+using direct_dependencies_t = meta_list_filter_t<meta_list_concat_t<
+	construct_dependencies_t<T>,
+	detected_or<meta_list<>, default_dependency_t, T>,
+	typename autocall_dependencies<T>::type
+>, is_service>;
+
+/*
+ * State of a depth first walk in the dependency graph.
+ * Services are added to the order after their dependencies, which makes it a topological order.
+ */
+template<typename Seen, typename Order>
+struct dependency_walk {
+	using seen = Seen;
+	using order = Order;
+};
+
+template<template<typename> class Descend, typename Walk, typename T, bool = meta_list_contains<T, typename Walk::seen>::value>
+struct dependency_visit {
+	using type = Walk;
+};
+
+template<template<typename> class Descend, typename Walk, typename List>
+struct dependency_visit_all {
+	using type = Walk;
+};
+
+template<template<typename> class Descend, typename Walk, typename Head, typename... Tail>
+struct dependency_visit_all<Descend, Walk, meta_list<Head, Tail...>> :
+	dependency_visit_all<Descend, typename dependency_visit<Descend, Walk, Head>::type, meta_list<Tail...>> {};
+
+/*
+ * Visits a service seen for the first time.
+ * Dependencies are only walked for services the Descend trait is true for.
+ */
+template<template<typename> class Descend, typename Walk, typename T>
+struct dependency_visit<Descend, Walk, T, false> {
+private:
+	using marked = dependency_walk<meta_list_push_back_t<typename Walk::seen, T>, typename Walk::order>;
+	using visited = typename dependency_visit_all<
+		Descend, marked, conditional_t<Descend<T>::value, direct_dependencies_t<T>, meta_list<>>
+	>::type;
+
+public:
+	using type = dependency_walk<typename visited::seen, meta_list_push_back_t<typename visited::order, T>>;
+};
+
+template<typename>
+struct descend_all : std::true_type {};
+
+template<typename T>
+struct descend_non_single : bool_constant<!is_single<T>::value> {};
+
+/*
+ * Every service needed to construct the services in the list, singles or not, in an order where dependencies come first.
+ */
+template<typename List>
+using dependency_order_t = typename dependency_visit_all<descend_all, dependency_walk<meta_list<>, meta_list<>>, List>::type::order;
+
+/*
+ * Every single needed to construct the services in the list, in an order where dependencies come first.
+ */
+template<typename List>
+using dependency_closure_t = meta_list_filter_t<dependency_order_t<List>, is_single>;
+
+/*
+ * Every service that is constructed along with T, stopping at singles.
+ */
+template<typename T>
+using reached_dependencies_t = typename dependency_visit_all<
+	descend_non_single, dependency_walk<meta_list<T>, meta_list<>>, direct_dependencies_t<T>
+>::type::order;
+
+/*
+ * The singles T needs, including the ones needed by the non single services it injects.
+ */
+template<typename T>
+using single_dependencies_t = meta_list_filter_t<reached_dependencies_t<T>, is_single>;
+
+/*
+ * Trait that tells if constructing T injects the container.
+ * Such services, like autowired ones, find some of their dependencies at runtime.
+ */
+template<typename T>
+using is_container_dependent = bool_constant<
+	is_container_service<T>::value || meta_list_contains<container_service, reached_dependencies_t<T>>::value
+>;
+
+template<typename List>
+struct contained_in {
+	template<typename T>
+	using trait = meta_list_contains<T, List>;
+};
+
+/*
+ * The services of the list that override one of the parents.
+ */
+template<typename List, typename Parents>
+struct overriders_of {
+private:
+	template<typename S>
+	using overrides_one = bool_constant<!meta_list_empty<meta_list_filter_t<
+		parent_types<S>, contained_in<Parents>::template trait
+	>>::value>;
+
+public:
+	using type = meta_list_filter_t<List, overrides_one>;
+};
+
+/*
+ * The singles of the closure that must be constructed before T.
+ * Those are its dependencies, and the services of the closure that override T or one of its dependencies,
+ * so that T sees the same overrides it would see if they were constructed in order.
+ */
+template<typename Closure, typename T>
+struct graph_dependencies {
+private:
+	template<typename S>
+	using is_other = bool_constant<!std::is_same<S, T>::value>;
+	
+	using singles = single_dependencies_t<T>;
+
+public:
+	using type = meta_list_filter_t<meta_list_concat_t<
+		singles,
+		typename overriders_of<Closure, meta_list_push_back_t<singles, T>>::type
+	>, is_other>;
+};
+
+template<typename Closure, typename T>
+using graph_dependencies_t = typename graph_dependencies<Closure, T>::type;
+
+/*
+ * The list without its repeated types, keeping the first of each.
+ */
+template<typename List, typename Result = meta_list<>>
+struct dependency_set {
+	using type = Result;
+};
+
+template<typename Head, typename... Tail, typename Result>
+struct dependency_set<meta_list<Head, Tail...>, Result> : dependency_set<
+	meta_list<Tail...>,
+	conditional_t<meta_list_contains<Head, Result>::value, Result, meta_list_push_back_t<Result, Head>>
+> {};
+
+template<typename List>
+using dependency_set_t = typename dependency_set<List>::type;
+
+/*
+ * The position of each dependency of T in the order, as integral constants.
+ */
+template<typename Order, typename T>
+struct dependency_indices {
+private:
+	template<typename D>
+	using index = std::integral_constant<std::size_t, meta_list_find<D, Order>::value>;
+
+public:
+	using type = meta_list_transform_t<dependency_set_t<direct_dependencies_t<T>>, index>;
+};
+
+template<typename Order, typename T>
+using dependency_indices_t = typename dependency_indices<Order, T>::type;
+
+template<std::size_t... Values>
+struct static_max : std::integral_constant<std::size_t, 0> {};
+
+template<std::size_t First, std::size_t... Rest>
+struct static_max<First, Rest...> : std::integral_constant<std::size_t,
+	(First > static_max<Rest...>::value ? First : static_max<Rest...>::value)
+> {};
+
+/*
+ * The depth a dependency adds to a node, from the depths of the nodes before it.
+ * A dependency that comes later in the order closes a cycle, and is ignored.
+ */
+template<typename Index, typename Depths, bool = (Index::value < meta_list_size<Depths>::value)>
+struct dependency_depth_through : std::integral_constant<std::size_t, 0> {};
+
+template<typename Index, typename Depths>
+struct dependency_depth_through<Index, Depths, true> :
+	std::integral_constant<std::size_t, meta_list_element_t<Index::value, Depths>::value + 1> {};
+
+template<typename Indices, typename Depths>
+struct node_depth;
+
+template<typename... Indices, typename Depths>
+struct node_depth<meta_list<Indices...>, Depths> : static_max<dependency_depth_through<Indices, Depths>::value...> {};
+
+/*
+ * The length of the longest chain of dependencies below each service of the order.
+ * Services without dependencies have a depth of zero.
+ */
+template<typename Order, typename Remaining = Order, typename Depths = meta_list<>>
+struct dependency_depths {
+	using type = Depths;
+};
+
+template<typename Order, typename Head, typename... Tail, typename... Depths>
+struct dependency_depths<Order, meta_list<Head, Tail...>, meta_list<Depths...>> : dependency_depths<
+	Order,
+	meta_list<Tail...>,
+	meta_list<Depths..., std::integral_constant<std::size_t,
+		node_depth<dependency_indices_t<Order, Head>, meta_list<Depths...>>::value
+	>>
+> {};
+
+template<typename Order>
+using dependency_depths_t = typename dependency_depths<Order>::type;
+
+/*
+ * The sums of the values before each element of a list of integral constants, followed by the sum of all of them.
+ */
+template<typename Values, std::size_t Sum = 0, typename Result = meta_list<>>
+struct prefix_sums {
+	using type = meta_list_push_back_t<Result, std::integral_constant<std::size_t, Sum>>;
+};
+
+template<typename Head, typename... Tail, std::size_t Sum, typename Result>
+struct prefix_sums<meta_list<Head, Tail...>, Sum, Result> : prefix_sums<
+	meta_list<Tail...>,
+	Sum + Head::value,
+	meta_list_push_back_t<Result, std::integral_constant<std::size_t, Sum>>
+> {};
+
+template<typename Values>
+using prefix_sums_t = typename prefix_sums<Values>::type;
+
+/*
+ * Holds the values of a list of integral constants in an array usable in constant expressions.
+ * The array always has one more element, so an empty list still makes a valid array.
+ */
+template<typename>
+struct static_values;
+
+template<typename... Values>
+struct static_values<meta_list<Values...>> {
+	static constexpr std::size_t values[] = {Values::value..., 0};
+};
+
+template<typename... Values>
+constexpr std::size_t static_values<meta_list<Values...>>::values[];
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_DEPENDENCY_GRAPH_HPP
@@ -0,0 +1,81 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FOR_EACH_SCHEDULE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FOR_EACH_SCHEDULE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+
+#include "define.hpp"
+
+namespace kgr {
+namespace detail {
+
+/*
+ * State shared by the tasks of a parallel for each.
+ *
+ * Elements are split in chunks that are taken in order from an atomic cursor.
+ * A thread takes its next chunk only once it's done with the previous one,
+ * so idle threads take the chunks that slower threads did not reach yet.
+ * The other members are guarded by the mutex.
+ */
+struct for_each_schedule {
+	explicit for_each_schedule(std::size_t const element_count, std::size_t const chunk) noexcept :
+		size{element_count}, chunk_size{std::max(chunk, std::size_t{1})} {}
+	
+	/*
+	 * Returns the number of chunks the elements are split in.
+	 */
+	auto chunk_count() const noexcept -> std::size_t {
+		return (size + chunk_size - 1) / chunk_size;
+	}
+	
+	/*
+	 * Takes the next chunk, and sets its bounds. Returns false when every chunk was taken.
+	 */
+	auto take(std::size_t& begin, std::size_t& end) noexcept -> bool {
+		begin = next.fetch_add(chunk_size, std::memory_order_relaxed);
+		
+		if (begin >= size) {
+			return false;
+		}
+		
+		end = std::min(begin + chunk_size, size);
+		return true;
+	}
+	
+	/*
+	 * Returns whether chunks are left to take.
+	 */
+	auto pending() const noexcept -> bool {
+		return next.load(std::memory_order_relaxed) < size;
+	}
+	
+	/*
+	 * Prevents any other chunk to be taken.
+	 */
+	void stop() noexcept {
+		next.store(size, std::memory_order_relaxed);
+	}
+	
+	std::size_t const size;
+	std::size_t const chunk_size;
+	std::atomic<std::size_t> next{0};
+	
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::size_t busy = 0;
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+	std::exception_ptr error;
+#endif
+};
+
+} // namespace detail
+} // namespace kgr
+
+#include "undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FOR_EACH_SCHEDULE_HPP
@@ -0,0 +1,350 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FROZEN_SERVICE_TABLE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FROZEN_SERVICE_TABLE_HPP
+
+#include "service_storage.hpp"
+#include "service_table.hpp"
+
+#include "../type_id.hpp"
+#include "../memory_resource.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <numeric>
+#include <vector>
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Immutable hash table that maps type ids to service storage, using a minimal perfect hash.
+ *
+ * The ids are split in buckets, and each bucket gets a seed that sends all its ids to free slots.
+ * This is the hash and displace method: larger buckets are placed first, while most slots are still free.
+ * There is exactly one slot per id, and finding an id reads one seed and compares one key, without probing.
+ *
+ * Ids that are not in the table still land on some slot, so the key of the slot is compared before returning.
+ *
+ * When type ids are indexed and their indices are dense enough, each id is simply placed at the slot of its index.
+ */
+struct frozen_service_table {
+private:
+	using seed_t = std::uint32_t;
+	
+	// Average amount of ids in a bucket. Larger buckets take less memory but more time to place.
+	static constexpr std::size_t bucket_load = 2;
+	
+	// Seeds tried for a bucket before starting over with twice the buckets
+	static constexpr seed_t maximum_seed = 1u << 16;
+	
+	// Ids are placed by index when it takes at most this many slots per id
+	static constexpr std::size_t maximum_index_load = 4;
+	
+	static_assert(alignof(type_id_t) <= alignof(service_storage), "Keys must be aligned when placed after the storages");
+	static_assert(alignof(seed_t) <= alignof(type_id_t), "Seeds must be aligned when placed after the keys");
+	
+	static auto allocation_size(std::size_t const slots, std::size_t const buckets) noexcept -> std::size_t {
+		return slots * (sizeof(service_storage) + sizeof(type_id_t)) + buckets * sizeof(seed_t);
+	}
+	
+	/*
+	 * Returns the slot of an id for a seed, in the range [0, slots).
+	 * The seed is mixed in all the bits of the id, so each seed sends the ids of a bucket to unrelated slots.
+	 * The upper bits of the hash are scaled to the amount of slots, which don't need to be a power of two.
+	 */
+	static auto slot_of(type_id_t const id, seed_t const seed, std::size_t const slots) noexcept -> std::size_t {
+		auto hash = (type_id_bits(id) ^ (std::uint64_t{seed} + 1) * std::uint64_t{0x9E3779B97F4A7C15}) * std::uint64_t{0xBF58476D1CE4E5B9};
+		hash = (hash ^ (hash >> 32)) * std::uint64_t{0x94D049BB133111EB};
+		return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(slots)) >> 32);
+	}
+	
+	auto bucket_of(type_id_t const id) const noexcept -> std::size_t {
+		return static_cast<std::size_t>(hash_type_id(id) >> 32) & _bucket_mask;
+	}
+	
+	/*
+	 * Returns the only slot the id can be in.
+	 * Slot zero never holds an indexed id, since indices start from one.
+	 */
+	auto slot_for(type_id_t const id) const noexcept -> std::size_t {
+#ifdef KGR_KANGARU_INDEXED_TYPE_ID
+		if (_indexed) {
+			auto const index = type_id_index(id);
+			return index < _slots ? index : 0;
+		}
+#endif
+		
+		return slot_of(id, _seeds[bucket_of(id)], _slots);
+	}
+	
+	// Arrays of a table with one empty slot, used when nothing was allocated
+	static auto empty_keys() noexcept -> type_id_t* {
+		static type_id_t keys[1] = {};
+		return keys;
+	}
+	
+	static auto empty_seeds() noexcept -> seed_t* {
+		static seed_t seeds[1] = {};
+		return seeds;
+	}
+
+public:
+	frozen_service_table() = default;
+	
+	/*
+	 * Builds the perfect hash of every service in the table.
+	 * The memory resource is used for the table and the temporary memory needed to build it.
+	 */
+	explicit frozen_service_table(service_table const& services, memory_resource& resource = new_delete_resource()) : _resource{&resource} {
+		if (!services.empty()) {
+			build(services);
+		}
+	}
+	
+	frozen_service_table(frozen_service_table const&) = delete;
+	frozen_service_table& operator=(frozen_service_table const&) = delete;
+	
+	frozen_service_table(frozen_service_table&& other) noexcept :
+		_values{other._values}, _keys{other._keys}, _seeds{other._seeds},
+		_slots{other._slots}, _bucket_mask{other._bucket_mask}, _size{other._size},
+		_indexed{other._indexed}, _resource{other._resource}
+	{
+		other.release();
+	}
+	
+	frozen_service_table& operator=(frozen_service_table&& other) noexcept {
+		if (this != &other) {
+			deallocate();
+			
+			_values = other._values;
+			_keys = other._keys;
+			_seeds = other._seeds;
+			_slots = other._slots;
+			_bucket_mask = other._bucket_mask;
+			_size = other._size;
+			_indexed = other._indexed;
+			_resource = other._resource;
+			
+			other.release();
+		}
+		
+		return *this;
+	}
+	
+	~frozen_service_table() {
+		deallocate();
+	}
+	
+	/*
+	 * Returns a pointer to the storage associated with the id, or null if not found.
+	 */
+	auto find(type_id_t const id) const noexcept -> service_storage const* {
+		auto const slot = slot_for(id);
+		return _keys[slot] == id ? _values + slot : nullptr;
+	}
+	
+	auto contains(type_id_t const id) const noexcept -> bool {
+		return find(id) != nullptr;
+	}
+	
+	/*
+	 * Returns the number of services in the table.
+	 */
+	auto size() const noexcept -> std::size_t {
+		return _size;
+	}
+	
+	auto empty() const noexcept -> bool {
+		return size() == 0;
+	}
+	
+	/*
+	 * Returns the number of bytes allocated by the table.
+	 */
+	auto memory_usage() const noexcept -> std::size_t {
+		return _values ? allocation_size(_slots, _bucket_mask + 1) : 0;
+	}
+
+private:
+	using ids_t = std::vector<type_id_t, resource_allocator<type_id_t>>;
+	using sizes_t = std::vector<std::size_t, resource_allocator<std::size_t>>;
+	
+	void build(service_table const& services) {
+#ifdef KGR_KANGARU_INDEXED_TYPE_ID
+		if (place_indexed(services)) return;
+#endif
+		
+		auto const slots = services.size();
+		auto buckets = std::size_t{1};
+		
+		while (buckets * bucket_load < slots) {
+			buckets *= 2;
+		}
+		
+		while (!place(services, slots, buckets)) {
+			buckets *= 2;
+		}
+	}
+	
+	/*
+	 * Tries to find a seed for each bucket, placing the largest buckets first.
+	 * Returns false if a bucket could not be placed, leaving this table empty.
+	 */
+	auto place(service_table const& services, std::size_t const slots, std::size_t const buckets) -> bool {
+		allocate(services.size(), slots, buckets);
+		
+		auto const values = _values;
+		
+		// Sorts the ids by bucket, with offsets[b] being where the ids of the bucket b start
+		sizes_t offsets(buckets + 1, 0, resource_allocator<std::size_t>{*_resource});
+		ids_t ids(slots, type_id_t{}, resource_allocator<type_id_t>{*_resource});
+		
+		for (auto const& service : services) {
+			++offsets[bucket_of(service.first) + 1];
+		}
+		
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		
+		{
+			sizes_t next(offsets.begin(), offsets.end() - 1, resource_allocator<std::size_t>{*_resource});
+			
+			for (auto const& service : services) {
+				ids[next[bucket_of(service.first)]++] = service.first;
+			}
+		}
+		
+		sizes_t order(buckets, 0, resource_allocator<std::size_t>{*_resource});
+		
+		for (std::size_t bucket = 0 ; bucket < buckets ; ++bucket) {
+			order[bucket] = bucket;
+		}
+		
+		std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+			return offsets[lhs + 1] - offsets[lhs] > offsets[rhs + 1] - offsets[rhs];
+		});
+		
+		sizes_t placed(bucket_load * 2, 0, resource_allocator<std::size_t>{*_resource});
+		
+		for (auto const bucket : order) {
+			auto const first = ids.begin() + static_cast<std::ptrdiff_t>(offsets[bucket]);
+			auto const last = ids.begin() + static_cast<std::ptrdiff_t>(offsets[bucket + 1]);
+			
+			if (first == last) break;
+			
+			placed.resize(static_cast<std::size_t>(last - first));
+			
+			if (!place_bucket(bucket, first, last, placed)) {
+				deallocate();
+				return false;
+			}
+		}
+		
+		for (auto const& service : services) {
+			values[slot_of(service.first, _seeds[bucket_of(service.first)], slots)] = service.second;
+		}
+		
+		return true;
+	}
+	
+#ifdef KGR_KANGARU_INDEXED_TYPE_ID
+	/*
+	 * Places each id at the slot of its index, if the indices are dense enough.
+	 * Returns false if it would take too many slots, leaving this table empty.
+	 */
+	auto place_indexed(service_table const& services) -> bool {
+		auto last = std::size_t{0};
+		
+		for (auto const& service : services) {
+			last = std::max(last, type_id_index(service.first));
+		}
+		
+		if (last > services.size() * maximum_index_load) {
+			return false;
+		}
+		
+		allocate(services.size(), last + 1, 1);
+		_indexed = true;
+		
+		for (auto const& service : services) {
+			_keys[type_id_index(service.first)] = service.first;
+			_values[type_id_index(service.first)] = service.second;
+		}
+		
+		return true;
+	}
+#endif
+	
+	void allocate(std::size_t const size, std::size_t const slots, std::size_t const buckets) {
+		auto const memory = _resource->allocate(allocation_size(slots, buckets), alignof(service_storage));
+		
+		_values = ::new (memory) service_storage[slots]();
+		_keys = ::new (static_cast<void*>(_values + slots)) type_id_t[slots]();
+		_seeds = ::new (static_cast<void*>(_keys + slots)) seed_t[buckets]();
+		_slots = slots;
+		_bucket_mask = buckets - 1;
+		_size = size;
+	}
+	
+	/*
+	 * Finds a seed that sends every id of the bucket to a free slot, then marks those slots as taken.
+	 */
+	auto place_bucket(std::size_t const bucket, ids_t::const_iterator const first, ids_t::const_iterator const last, sizes_t& placed) -> bool {
+		for (seed_t seed = 0 ; seed < maximum_seed ; ++seed) {
+			auto count = std::size_t{0};
+			
+			for (auto id = first ; id != last ; ++id, ++count) {
+				auto const slot = slot_of(*id, seed, _slots);
+				
+				if (_keys[slot] != type_id_t{}) break;
+				
+				_keys[slot] = *id;
+				placed[count] = slot;
+			}
+			
+			if (first + static_cast<std::ptrdiff_t>(count) == last) {
+				_seeds[bucket] = seed;
+				return true;
+			}
+			
+			// Frees the slots taken by the ids placed with this seed
+			for (std::size_t nth = 0 ; nth < count ; ++nth) {
+				_keys[placed[nth]] = type_id_t{};
+			}
+		}
+		
+		return false;
+	}
+	
+	void deallocate() noexcept {
+		if (_values) {
+			_resource->deallocate(_values, allocation_size(_slots, _bucket_mask + 1), alignof(service_storage));
+		}
+		
+		release();
+	}
+	
+	void release() noexcept {
+		_values = nullptr;
+		_keys = empty_keys();
+		_seeds = empty_seeds();
+		_slots = 1;
+		_bucket_mask = 0;
+		_size = 0;
+		_indexed = false;
+	}
+	
+	service_storage* _values = nullptr;
+	type_id_t* _keys = empty_keys();
+	seed_t* _seeds = empty_seeds();
+	std::size_t _slots = 1;
+	std::size_t _bucket_mask = 0;
+	std::size_t _size = 0;
+	bool _indexed = false;
+	memory_resource* _resource = &new_delete_resource();
+};
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_FROZEN_SERVICE_TABLE_HPP
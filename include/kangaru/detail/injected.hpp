@@ -59,10 +59,25 @@ struct virtual_injected {
 		_service{storage.service}, _forward{storage.forward} {}
 	
 	service_type<T> forward() {
+		return forward(std::is_lvalue_reference<service_type<T>>{});
+	}
+
+private:
+	/*
+	 * When the service was forwarded ahead of time, the reference is returned without calling the forward function.
+	 */
+	service_type<T> forward(std::true_type) {
+		if (_forward == &forward_reference<T>) {
+			return *static_cast<typename std::remove_reference<service_type<T>>::type*>(_service);
+		}
+		
+		return _forward(_service);
+	}
+	
+	service_type<T> forward(std::false_type) {
 		return _forward(_service);
 	}
 	
-private:
 	void* _service;
 	forward_ptr<T> _forward;
 };
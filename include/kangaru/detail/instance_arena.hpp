@@ -0,0 +1,314 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_INSTANCE_ARENA_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_INSTANCE_ARENA_HPP
+
+#include "kangaru/detail/config.hpp"
+
+#include "../memory_resource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "define.hpp"
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Storage for the instances of single services.
+ *
+ * Instances are placed one after the other in large chunks of memory instead of
+ * being allocated one by one. Every instance is recorded with its destructor so
+ * they are destroyed in order of construction, or in reverse order when
+ * KGR_KANGARU_REVERSE_DESTRUCTION is defined.
+ *
+ * Chunks remember the memory resource they come from, since merging arenas
+ * can bring chunks allocated by another resource.
+ */
+struct instance_arena {
+private:
+	using destructor_t = void(*)(void*) KGR_KANGARU_CXX17_NOEXCEPT;
+	
+	struct instance {
+		void* pointer;
+		destructor_t destructor;
+	};
+	
+	struct chunk {
+		void* memory;
+		std::size_t size;
+		memory_resource* resource;
+	};
+	
+	static constexpr std::size_t initial_chunk_size = 1024;
+	static constexpr std::size_t maximum_chunk_size = 64 * 1024;
+	
+	template<typename T>
+	static void destroy(void* instance) KGR_KANGARU_CXX17_NOEXCEPT {
+		static_cast<T*>(instance)->~T();
+	}
+	
+	/*
+	 * Makes room for one more element without relying on the growth policy of reserve.
+	 */
+	template<typename T>
+	static void reserve_one(std::vector<T, resource_allocator<T>>& vector) {
+		if (vector.size() == vector.capacity()) {
+			vector.reserve(vector.empty() ? 8 : vector.size() * 2);
+		}
+	}
+	
+	/*
+	 * Makes room for `count` more elements, still doubling the capacity so that merging many arenas stays linear.
+	 */
+	template<typename T>
+	static void reserve_more(std::vector<T, resource_allocator<T>>& vector, std::size_t const count) {
+		if (vector.capacity() - vector.size() < count) {
+			auto const doubled = vector.empty() ? std::size_t{8} : vector.size() * 2;
+			vector.reserve(vector.size() + count > doubled ? vector.size() + count : doubled);
+		}
+	}
+	
+	/*
+	 * Returns the address `size` bytes can be placed in the current chunk with the requested alignment.
+	 * Returns null if the current chunk don't have enough room.
+	 */
+	auto bump(std::size_t const size, std::size_t const alignment) noexcept -> void* {
+		auto const address = reinterpret_cast<std::uintptr_t>(_current);
+		auto const aligned = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+		auto const padding = static_cast<std::size_t>(aligned - address);
+		
+		if (_current == nullptr || padding + size > _remaining) {
+			return nullptr;
+		}
+		
+		_current += padding + size;
+		_remaining -= padding + size;
+		
+		return reinterpret_cast<void*>(aligned);
+	}
+	
+	auto allocate(std::size_t const size, std::size_t const alignment) -> void* {
+		if (auto const memory = bump(size, alignment)) {
+			return memory;
+		}
+		
+		auto chunk_size = std::size_t{initial_chunk_size};
+		
+		if (!_chunks.empty()) {
+			chunk_size = _chunks.back().size * 2;
+		}
+		
+		if (chunk_size > maximum_chunk_size) {
+			chunk_size = maximum_chunk_size;
+		}
+		
+		// Services too large for a regular chunk get a chunk of their own
+		if (chunk_size < size + alignment) {
+			chunk_size = size + alignment;
+		}
+		
+		reserve_one(_chunks);
+		
+		auto const memory = _resource->allocate(chunk_size, alignof(std::max_align_t));
+		_chunks.push_back(chunk{memory, chunk_size, _resource});
+		_current = static_cast<unsigned char*>(memory);
+		_remaining = chunk_size;
+		
+		return bump(size, alignment);
+	}
+	
+	void release() noexcept {
+		for (auto const& chunk : _chunks) {
+			chunk.resource->deallocate(chunk.memory, chunk.size, alignof(std::max_align_t));
+		}
+		
+		_chunks.clear();
+		_current = nullptr;
+		_remaining = 0;
+	}
+
+public:
+	instance_arena() = default;
+	
+	explicit instance_arena(memory_resource& resource) noexcept :
+		_resource{&resource}, _instances{resource}, _chunks{resource} {}
+	
+	instance_arena(instance_arena const&) = delete;
+	instance_arena& operator=(instance_arena const&) = delete;
+	
+	instance_arena(instance_arena&& other) noexcept :
+		_resource{other._resource},
+		_instances{std::move(other._instances)},
+		_chunks{std::move(other._chunks)},
+		_current{other._current},
+		_remaining{other._remaining}
+	{
+		other._instances.clear();
+		other._chunks.clear();
+		other._current = nullptr;
+		other._remaining = 0;
+	}
+	
+	instance_arena& operator=(instance_arena&& other) noexcept {
+		clear();
+		
+		_resource = other._resource;
+		_instances = std::move(other._instances);
+		_chunks = std::move(other._chunks);
+		_current = other._current;
+		_remaining = other._remaining;
+		
+		other._instances.clear();
+		other._chunks.clear();
+		other._current = nullptr;
+		other._remaining = 0;
+		
+		return *this;
+	}
+	
+	inline ~instance_arena() {
+		clear();
+	}
+	
+	/*
+	 * Constructs an instance of T in the arena and returns a pointer to it.
+	 * If the constructor throws, the memory is given back to the arena.
+	 */
+	template<typename T, typename... Args>
+	auto emplace(Args&&... args) -> T* {
+		reserve_one(_instances);
+		
+		// If the constructor throws, the guard rewinds the arena where it was before the allocation
+		struct rewind_guard {
+			instance_arena* arena;
+			unsigned char* current;
+			std::size_t remaining;
+			
+			~rewind_guard() {
+				if (arena) {
+					arena->_current = current;
+					arena->_remaining = remaining;
+				}
+			}
+		} guard{this, _current, _remaining};
+		
+		auto const instance = ::new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+		guard.arena = nullptr;
+		
+		_instances.push_back(instance_arena::instance{instance, &instance_arena::destroy<T>});
+		
+		return instance;
+	}
+	
+	/*
+	 * Returns memory for `count` objects of T, placed in the chunks along with the instances.
+	 * Those objects are not recorded as instances, so T must be trivially destructible.
+	 * Their memory is released with the chunks.
+	 */
+	template<typename T>
+	auto allocate_array(std::size_t const count) -> T* {
+		static_assert(std::is_trivially_destructible<T>::value, "Objects allocated in an array are never destroyed");
+		
+		return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+	}
+	
+	/*
+	 * Destroys all instances and releases all chunks of memory.
+	 */
+	void clear() noexcept {
+#ifdef KGR_KANGARU_REVERSE_DESTRUCTION
+		for (auto it = _instances.rbegin() ; it != _instances.rend() ; ++it) {
+			it->destructor(it->pointer);
+		}
+#else
+		for (auto const& instance : _instances) {
+			instance.destructor(instance.pointer);
+		}
+#endif
+
+		_instances.clear();
+		release();
+	}
+	
+	/*
+	 * Takes ownership of all instances of another arena.
+	 * Instances of the other arena will be destroyed after the instances of this one.
+	 */
+	void merge(instance_arena&& other) {
+		reserve_more(_instances, other._instances.size());
+		reserve_more(_chunks, other._chunks.size());
+		
+		_instances.insert(_instances.end(), other._instances.begin(), other._instances.end());
+		_chunks.insert(_chunks.end(), other._chunks.begin(), other._chunks.end());
+		
+		other._instances.clear();
+		other._chunks.clear();
+		other._current = nullptr;
+		other._remaining = 0;
+	}
+	
+	/*
+	 * Makes room for `count` more instances, taking at most `bytes` bytes in total.
+	 * If the current chunk is too small, a chunk large enough for all of them is allocated.
+	 */
+	void reserve(std::size_t const count, std::size_t const bytes) {
+		_instances.reserve(_instances.size() + count);
+		
+		if (bytes > _remaining) {
+			auto const chunk_size = bytes > initial_chunk_size ? bytes : std::size_t{initial_chunk_size};
+			
+			reserve_one(_chunks);
+			
+			auto const memory = _resource->allocate(chunk_size, alignof(std::max_align_t));
+			_chunks.push_back(chunk{memory, chunk_size, _resource});
+			_current = static_cast<unsigned char*>(memory);
+			_remaining = chunk_size;
+		}
+	}
+	
+	/*
+	 * Returns the memory resource new chunks are allocated from.
+	 */
+	auto resource() const noexcept -> memory_resource& {
+		return *_resource;
+	}
+	
+	/*
+	 * Returns the number of instances in the arena.
+	 */
+	auto size() const noexcept -> std::size_t {
+		return _instances.size();
+	}
+	
+	/*
+	 * Returns the number of bytes reserved by the arena to hold instances.
+	 */
+	auto capacity() const noexcept -> std::size_t {
+		std::size_t total = 0;
+		
+		for (auto const& chunk : _chunks) {
+			total += chunk.size;
+		}
+		
+		return total;
+	}
+
+private:
+	memory_resource* _resource = &new_delete_resource();
+	std::vector<instance, resource_allocator<instance>> _instances;
+	std::vector<chunk, resource_allocator<chunk>> _chunks;
+	unsigned char* _current = nullptr;
+	std::size_t _remaining = 0;
+};
+
+} // namespace detail
+} // namespace kgr
+
+#include "undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_INSTANCE_ARENA_HPP
@@ -0,0 +1,136 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_KEY_SCAN_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_KEY_SCAN_HPP
+
+#include "../type_id.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+#include "define.hpp"
+
+#if defined(KGR_KANGARU_KEY_SCAN_AVX2) || defined(KGR_KANGARU_KEY_SCAN_SSE2)
+#include <immintrin.h>
+#elif defined(KGR_KANGARU_KEY_SCAN_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Returns the bits of a type id as an integer, whether it's a pointer or a hash.
+ */
+inline auto type_id_bits(void const* id) noexcept -> std::uint64_t {
+	return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(id));
+}
+
+inline auto type_id_bits(std::uint64_t id) noexcept -> std::uint64_t {
+	return id;
+}
+
+/*
+ * Returns the index of the first bit set in a non zero mask.
+ */
+inline auto first_bit(unsigned int const mask) noexcept -> std::size_t {
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<std::size_t>(__builtin_ctz(mask));
+#else
+	auto index = std::size_t{0};
+	
+	while ((mask >> index & 1u) == 0) {
+		++index;
+	}
+	
+	return index;
+#endif
+}
+
+/*
+ * Number of keys compared before branching on the result.
+ */
+constexpr std::size_t key_block_size = 8;
+
+/*
+ * Returns a mask with the bit n set when the nth key of a block is equal to the id.
+ *
+ * Vector instructions compare four keys at once with AVX2, or two with SSE2 and NEON.
+ * They are only selected on 64 bit targets, where both pointer and hash ids are 64 bits.
+ */
+inline auto match_key_block(type_id_t const* keys, type_id_t const id) noexcept -> unsigned int {
+#if defined(KGR_KANGARU_KEY_SCAN_AVX2)
+	static_assert(sizeof(type_id_t) == 8, "AVX2 key scan requires 64 bit type ids");
+	auto const needle = _mm256_set1_epi64x(static_cast<long long>(type_id_bits(id)));
+	auto const low = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys)), needle);
+	auto const high = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + 4)), needle);
+	
+	return static_cast<unsigned int>(
+		_mm256_movemask_pd(_mm256_castsi256_pd(low)) |
+		_mm256_movemask_pd(_mm256_castsi256_pd(high)) << 4
+	);
+#elif defined(KGR_KANGARU_KEY_SCAN_SSE2)
+	static_assert(sizeof(type_id_t) == 8, "SSE2 key scan requires 64 bit type ids");
+	auto const needle = _mm_set1_epi64x(static_cast<long long>(type_id_bits(id)));
+	auto mask = 0u;
+	
+	for (std::size_t pair = 0 ; pair < key_block_size ; pair += 2) {
+		// SSE2 only compares 32 bit lanes, so a key is equal when both of its halves are
+		auto const halves = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + pair)), needle);
+		auto const equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+		mask |= static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(equal))) << pair;
+	}
+	
+	return mask;
+#elif defined(KGR_KANGARU_KEY_SCAN_NEON)
+	static_assert(sizeof(type_id_t) == 8, "NEON key scan requires 64 bit type ids");
+	auto const needle = vdupq_n_u64(type_id_bits(id));
+	auto mask = 0u;
+	
+	for (std::size_t pair = 0 ; pair < key_block_size ; pair += 2) {
+		auto const chunk = vreinterpretq_u64_u8(vld1q_u8(reinterpret_cast<std::uint8_t const*>(keys + pair)));
+		auto const equal = vceqq_u64(chunk, needle);
+		mask |= static_cast<unsigned int>((vgetq_lane_u64(equal, 0) & 1u) | (vgetq_lane_u64(equal, 1) & 2u)) << pair;
+	}
+	
+	return mask;
+#else
+	auto mask = 0u;
+	
+	for (std::size_t nth = 0 ; nth < key_block_size ; ++nth) {
+		mask |= static_cast<unsigned int>(keys[nth] == id) << nth;
+	}
+	
+	return mask;
+#endif
+}
+
+/*
+ * Returns the index of the id in an array of packed keys, or `size` if it's not there.
+ *
+ * Keys are compared a whole block at a time, which only branches once per block.
+ * The keys of the last block past `size` are read but ignored, so the array must be a whole number of blocks.
+ */
+template<std::size_t capacity>
+auto find_key(type_id_t const (&keys)[capacity], std::size_t const size, type_id_t const id) noexcept -> std::size_t {
+	static_assert(capacity % key_block_size == 0, "Packed keys must be a whole number of blocks");
+	
+	for (std::size_t block = 0 ; block < size ; block += key_block_size) {
+		auto mask = match_key_block(keys + block, id);
+		
+		if (size - block < key_block_size) {
+			mask &= (1u << (size - block)) - 1u;
+		}
+		
+		if (mask != 0) {
+			return block + first_bit(mask);
+		}
+	}
+	
+	return size;
+}
+
+} // namespace detail
+} // namespace kgr
+
+#include "undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_KEY_SCAN_HPP
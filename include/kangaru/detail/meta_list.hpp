@@ -170,6 +170,52 @@ struct meta_list_empty;
 template<typename... Types>
 struct meta_list_empty<meta_list<Types...>> : std::integral_constant<bool, sizeof...(Types) == 0> {};
 
+/*
+ * This trait returns the list with a type added at the end.
+ */
+template<typename, typename>
+struct meta_list_push_back;
+
+template<typename... Types, typename T>
+struct meta_list_push_back<meta_list<Types...>, T> {
+	using type = meta_list<Types..., T>;
+};
+
+template<typename List, typename T>
+using meta_list_push_back_t = typename meta_list_push_back<List, T>::type;
+
+/*
+ * This trait returns the concatenation of many lists.
+ */
+template<typename...>
+struct meta_list_concat {
+	using type = meta_list<>;
+};
+
+template<typename... Types>
+struct meta_list_concat<meta_list<Types...>> {
+	using type = meta_list<Types...>;
+};
+
+template<typename... Types1, typename... Types2, typename... Lists>
+struct meta_list_concat<meta_list<Types1...>, meta_list<Types2...>, Lists...> :
+	meta_list_concat<meta_list<Types1..., Types2...>, Lists...> {};
+
+template<typename... Lists>
+using meta_list_concat_t = typename meta_list_concat<Lists...>::type;
+
+/*
+ * This trait returns the list of the types for which the trait is true, in the same order.
+ */
+template<typename, template<typename> class>
+struct meta_list_filter;
+
+template<typename... Types, template<typename> class Trait>
+struct meta_list_filter<meta_list<Types...>, Trait> :
+	meta_list_concat<typename std::conditional<Trait<Types>::value, meta_list<Types>, meta_list<>>::type...> {};
+
+template<typename List, template<typename> class Trait>
+using meta_list_filter_t = typename meta_list_filter<List, Trait>::type;
 
 } // namespace detail
 } // namespace kgr
@@ -22,6 +22,22 @@ private:
 	override_range<detail::override_iterator<T>> _range;
 };
 
+/*
+ * Service that yields a view of every overrides of T.
+ * Unlike override_range_service, services yielding non-trivial types are supported, and the view can be indexed.
+ */
+template<typename T>
+struct override_view_service : detail::override_range_service_tag {
+	explicit override_view_service(override_view<T> view) noexcept : _view{std::move(view)} {}
+	
+	auto forward() -> override_view<T> {
+		return std::move(_view);
+	}
+
+private:
+	override_view<T> _view;
+};
+
 namespace detail {
 
 template<typename T>
@@ -35,6 +51,17 @@ struct override_range_service_type<override_range_service<T>> {
 	using type = T;
 };
 
+template<typename T>
+struct override_range_service_type<override_view_service<T>> {
+	using type = T;
+};
+
+template<typename>
+struct is_override_view_service : std::false_type {};
+
+template<typename T>
+struct is_override_view_service<override_view_service<T>> : std::true_type {};
+
 template<typename T>
 using override_range_service_type_t = typename override_range_service_type<T>::type;
 
@@ -1,67 +1,89 @@
 #ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_OVERRIDE_STORAGE_SERVICE_HPP
 #define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_OVERRIDE_STORAGE_SERVICE_HPP
 
-#include <vector>
 #include <algorithm>
-#include <iterator>
+#include <cstddef>
+#include <memory>
+#include <utility>
 
-#include "single.hpp"
-#include "injected.hpp"
 #include "service_storage.hpp"
+#include "instance_arena.hpp"
 
 #include "../type_id.hpp"
 
 namespace kgr {
 namespace detail {
 
-struct override_storage {
-	using overrides_t = std::vector<std::vector<std::pair<type_id_t, service_storage>>>;
+/*
+ * An override of a service, with the type id of the overriding service.
+ */
+using override_record = std::pair<type_id_t, service_storage>;
+
+/*
+ * List of every service overriding a particular service.
+ *
+ * The list is a span of records placed in the chunks of an instance arena, so the records of every list
+ * of a source are packed together, and iterating a list is a linear scan.
+ * When a list is full, its records are moved to a span twice as large at the end of the arena.
+ *
+ * Lists are reached through the index_storage entry of the overriden service.
+ * A list reachable from a frozen layer is never modified. A source that needs to add to it makes a copy first.
+ */
+struct override_list {
+	using value_type = override_record;
+	using iterator = override_record*;
+	using const_iterator = override_record const*;
 	
-	template<typename P>
-	auto filter(P predicate) const -> overrides_t {
-		overrides_t fork;
-		fork.reserve(overrides.capacity());
-		
-		std::transform(
-			overrides.begin(),
-			overrides.end(),
-			std::back_inserter(fork),
-			[&predicate](overrides_t::const_reference overrides) -> overrides_t::value_type {
-				overrides_t::value_type filtered;
-				filtered.reserve(overrides.capacity());
-				std::copy_if(
-					overrides.begin(),
-					overrides.end(),
-					std::back_inserter(filtered),
-					[&predicate](overrides_t::value_type::const_reference service) -> bool {
-						return predicate(service.first);
-					}
-				);
-				
-				return filtered;
-			}
-		);
-		
-		return fork;
+	// The capacity of a list when the first record is added
+	static constexpr std::size_t minimum_capacity = 4;
+	
+	auto begin() noexcept -> iterator {
+		return _records;
 	}
 	
-	overrides_t overrides;
-};
-
-struct override_storage_service : single {
-	override_storage service;
+	auto end() noexcept -> iterator {
+		return _records + _size;
+	}
 	
-	inline static auto construct() -> kgr::inject_result<> {
-		return kgr::inject();
+	auto begin() const noexcept -> const_iterator {
+		return _records;
 	}
 	
-	inline auto forward() -> override_storage& {
-		return service;
+	auto end() const noexcept -> const_iterator {
+		return _records + _size;
 	}
 	
-	inline auto forward() const -> override_storage const& {
-		return service;
+	auto size() const noexcept -> std::size_t {
+		return _size;
 	}
+	
+	/*
+	 * Makes room for at least `capacity` records.
+	 */
+	void reserve(std::size_t const capacity, instance_arena& arena) {
+		if (capacity > _capacity) {
+			auto const records = arena.allocate_array<override_record>(capacity);
+			std::uninitialized_copy(begin(), end(), records);
+			
+			_records = records;
+			_capacity = capacity;
+		}
+	}
+	
+	void push_back(override_record const& record, instance_arena& arena) {
+		if (_size == _capacity) {
+			reserve(std::max(_capacity * 2, std::size_t{minimum_capacity}), arena);
+		}
+		
+		::new (static_cast<void*>(_records + _size)) override_record(record);
+		++_size;
+	}
+
+private:
+
+	override_record* _records = nullptr;
+	std::size_t _size = 0;
+	std::size_t _capacity = 0;
 };
 
 template<typename>
@@ -0,0 +1,108 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_CACHE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_CACHE_HPP
+
+#include "service_storage.hpp"
+
+#include "../type_id.hpp"
+#include "../memory_resource.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace kgr {
+namespace detail {
+
+#ifdef KGR_KANGARU_INDEXED_TYPE_ID
+
+/*
+ * Returns the index of the cache slot of the service T.
+ * Type ids are already small and dense, so their index is used directly.
+ */
+template<typename T>
+auto cache_index() noexcept -> std::size_t {
+	return type_id_index(type_id<T>());
+}
+
+#else
+
+/*
+ * Returns a new index each time it is called, starting from zero.
+ */
+inline auto next_cache_index() noexcept -> std::size_t {
+	static std::atomic<std::size_t> counter{0};
+	return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*
+ * Returns the index of the cache slot of the service T.
+ * Indices are given on first use, so they stay small and dense for the types a program actually use.
+ */
+template<typename T>
+auto cache_index() noexcept -> std::size_t {
+	static std::size_t const index = next_cache_index();
+	return index;
+}
+
+#endif // KGR_KANGARU_INDEXED_TYPE_ID
+
+/*
+ * Dense array of service storage, indexed by the cache index of their type.
+ *
+ * Finding a service in the cache is a single indexed load, without hashing.
+ * An empty storage marks a slot that must be found the slow way.
+ * Only inserting services grows the cache, so finding and reseting slots never allocates.
+ */
+struct service_cache {
+	explicit service_cache(memory_resource& resource = new_delete_resource()) : _slots{resource_allocator<service_storage>{resource}} {}
+	
+	auto find(std::size_t const index) const noexcept -> service_storage const* {
+		return index < _slots.size() && !_slots[index].empty() ? &_slots[index] : nullptr;
+	}
+	
+	/*
+	 * Saves the storage in the slot, but only if the slot already exists.
+	 */
+	void assign(std::size_t const index, service_storage const& storage) noexcept {
+		if (index < _slots.size()) {
+			_slots[index] = storage;
+		}
+	}
+	
+	/*
+	 * Saves the storage in the slot, growing the cache if needed.
+	 */
+	void insert(std::size_t const index, service_storage const& storage) {
+		reserve(index + 1);
+		_slots[index] = storage;
+	}
+	
+	/*
+	 * Makes sure the cache has a slot for every index lower than `size`.
+	 */
+	void reserve(std::size_t const size) {
+		if (size > _slots.size()) {
+			_slots.resize(std::max(size, _slots.size() * 2));
+		}
+	}
+	
+	auto size() const noexcept -> std::size_t {
+		return _slots.size();
+	}
+	
+	/*
+	 * Empties every slot, keeping the memory.
+	 */
+	void reset() noexcept {
+		std::fill(_slots.begin(), _slots.end(), service_storage{});
+	}
+
+private:
+	std::vector<service_storage, resource_allocator<service_storage>> _slots;
+};
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_CACHE_HPP
@@ -0,0 +1,95 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_LAYER_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_LAYER_HPP
+
+#include "service_table.hpp"
+
+#include "../type_id.hpp"
+#include "../memory_resource.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Immutable snapshot of services, shared between a container and its forks.
+ *
+ * Layers form a chain. A lookup that misses in a layer continues in the next one,
+ * but only if the filter of the layer accepts the type id. A null filter accepts everything.
+ *
+ * A layer can also link the chain of another container as a fallback, which is how chained merges are O(1).
+ * Fallbacks are searched after every layer of the chain missed, starting from the deepest one,
+ * so services that were visible before a merge are preferred over the merged ones.
+ *
+ * The depth is the number of layers that can be flattened together, starting from this one
+ * and stopping at the first layer with a filter or a fallback.
+ */
+struct service_layer {
+	using filter_t = bool(*)(service_layer const&, type_id_t);
+	
+	/*
+	 * Above this depth, a source flattens its layers into one when taking a snapshot.
+	 */
+	static constexpr std::size_t maximum_depth = 8;
+	
+	explicit service_layer(service_table s, std::shared_ptr<service_layer const> n, filter_t f = nullptr, std::shared_ptr<service_layer const> fb = nullptr) noexcept :
+		services{std::move(s)},
+		next{std::move(n)},
+		fallback{std::move(fb)},
+		filter{f},
+		depth{next && next->flattenable() ? next->depth + 1 : 1},
+		chained{fallback || (next && next->chained)} {}
+	
+	service_layer(service_layer const&) = delete;
+	service_layer& operator=(service_layer const&) = delete;
+	
+	/*
+	 * Returns whether a lookup for this id can continue in the next layer.
+	 * Implementation defined services are never filtered.
+	 */
+	auto accepts(type_id_t const id) const -> bool {
+		return !filter || type_id_kind(id) != service_kind_t::normal || filter(*this, id);
+	}
+	
+	/*
+	 * Returns whether the services of this layer can be flattened with the layers above it.
+	 */
+	auto flattenable() const noexcept -> bool {
+		return !filter && !fallback;
+	}
+	
+	service_table services;
+	std::shared_ptr<service_layer const> next;
+	std::shared_ptr<service_layer const> fallback;
+	filter_t filter;
+	std::size_t depth;
+	
+	// Whether this layer or one of the next ones has a fallback
+	bool chained;
+};
+
+/*
+ * Layer that filters lookups going through it with a predicate.
+ * The predicate is only called with ids of normal services.
+ */
+template<typename Predicate>
+struct filtered_service_layer : service_layer {
+	explicit filtered_service_layer(memory_resource& resource, std::shared_ptr<service_layer const> n, Predicate p) :
+		service_layer{service_table{resource}, std::move(n), &filtered_service_layer::evaluate},
+		predicate(std::move(p)) {}
+	
+	// The predicate is copied from the fork call, which never required it to be callable when const.
+	mutable Predicate predicate;
+
+private:
+	static auto evaluate(service_layer const& layer, type_id_t const id) -> bool {
+		return static_cast<filtered_service_layer const&>(layer).predicate(id);
+	}
+};
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_LAYER_HPP
@@ -7,7 +7,12 @@
 #include "../type_id.hpp"
 #include "../optional.hpp"
 
+#include "../memory_resource.hpp"
+
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace kgr {
@@ -54,7 +59,7 @@ public:
 	using difference_type = std::ptrdiff_t;
 	using iterator_category = std::input_iterator_tag;
 	
-	explicit override_iterator(std::vector<std::pair<type_id_t, service_storage>>::iterator internal) noexcept :
+	explicit override_iterator(override_list::const_iterator internal) noexcept :
 		_internal{internal} {}
 	
 	friend auto operator!=(override_iterator const& lhs, override_iterator const& rhs) -> bool {
@@ -71,7 +76,7 @@ public:
 		return *this;
 	}
 	
-	auto operator++(int) -> override_storage {
+	auto operator++(int) -> override_iterator {
 		auto prev = *this;
 		++*this;
 		_service = {};
@@ -98,11 +103,193 @@ private:
 	
 	using service = T;
 	friend struct override_range<override_iterator<T>>;
-	std::vector<std::pair<type_id_t, service_storage>>::iterator _internal;
+	override_list::const_iterator _internal;
 	storage _service;
 };
 
+/*
+ * Random access iterator over the forwarded services of an override_view.
+ * Services forwarded as references are stored as pointers, and dereferenced back.
+ */
+template<typename T>
+struct override_view_iterator {
+private:
+	using stored = optional_stored_type<service_type<T>>;
+	
+	static auto unwrap(stored& service) noexcept -> typename std::remove_reference<service_type<T>>::type& {
+		return unwrap(service, std::is_lvalue_reference<service_type<T>>{});
+	}
+	
+	static auto unwrap(stored& service, std::true_type) noexcept -> typename std::remove_reference<service_type<T>>::type& {
+		return *service;
+	}
+	
+	static auto unwrap(stored& service, std::false_type) noexcept -> stored& {
+		return service;
+	}
+
+public:
+	using value_type = typename std::remove_reference<service_type<T>>::type;
+	using reference = value_type&;
+	using pointer = value_type*;
+	using difference_type = std::ptrdiff_t;
+	using iterator_category = std::random_access_iterator_tag;
+	
+	override_view_iterator() = default;
+	explicit override_view_iterator(stored* internal) noexcept : _internal{internal} {}
+	
+	auto operator*() const noexcept -> reference {
+		return unwrap(*_internal);
+	}
+	
+	auto operator->() const noexcept -> pointer {
+		return &unwrap(*_internal);
+	}
+	
+	auto operator[](difference_type const n) const noexcept -> reference {
+		return unwrap(_internal[n]);
+	}
+	
+	auto operator++() noexcept -> override_view_iterator& {
+		++_internal;
+		return *this;
+	}
+	
+	auto operator++(int) noexcept -> override_view_iterator {
+		auto prev = *this;
+		++_internal;
+		return prev;
+	}
+	
+	auto operator--() noexcept -> override_view_iterator& {
+		--_internal;
+		return *this;
+	}
+	
+	auto operator--(int) noexcept -> override_view_iterator {
+		auto prev = *this;
+		--_internal;
+		return prev;
+	}
+	
+	auto operator+=(difference_type const n) noexcept -> override_view_iterator& {
+		_internal += n;
+		return *this;
+	}
+	
+	auto operator-=(difference_type const n) noexcept -> override_view_iterator& {
+		_internal -= n;
+		return *this;
+	}
+	
+	friend auto operator+(override_view_iterator it, difference_type const n) noexcept -> override_view_iterator {
+		return it += n;
+	}
+	
+	friend auto operator+(difference_type const n, override_view_iterator it) noexcept -> override_view_iterator {
+		return it += n;
+	}
+	
+	friend auto operator-(override_view_iterator it, difference_type const n) noexcept -> override_view_iterator {
+		return it -= n;
+	}
+	
+	friend auto operator-(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> difference_type {
+		return lhs._internal - rhs._internal;
+	}
+	
+	friend auto operator==(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal == rhs._internal;
+	}
+	
+	friend auto operator!=(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal != rhs._internal;
+	}
+	
+	friend auto operator<(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal < rhs._internal;
+	}
+	
+	friend auto operator>(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal > rhs._internal;
+	}
+	
+	friend auto operator<=(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal <= rhs._internal;
+	}
+	
+	friend auto operator>=(override_view_iterator const& lhs, override_view_iterator const& rhs) noexcept -> bool {
+		return lhs._internal >= rhs._internal;
+	}
+
+private:
+	stored* _internal = nullptr;
+};
+
 } // namespace detail
+
+/*
+ * A view over every service overriding T, that can be iterated many times and indexed.
+ *
+ * The services are forwarded once when the view is created, and kept in a contiguous array.
+ * Services forwarded by value, like the ones of a shared_service, are kept by value in the view.
+ * Adding new overrides in the container don't change the view.
+ */
+template<typename T>
+struct override_view {
+private:
+	using stored = detail::optional_stored_type<service_type<T>>;
+	
+	static auto store(service_type<T> service, std::true_type) noexcept -> stored {
+		return &service;
+	}
+	
+	static auto store(service_type<T> service, std::false_type) -> stored {
+		return stored(std::move(service));
+	}
+
+public:
+	using service = T;
+	using iterator = detail::override_view_iterator<T>;
+	using value_type = typename iterator::value_type;
+	using reference = typename iterator::reference;
+	using size_type = std::size_t;
+	
+	explicit override_view(detail::override_list const& overrides, memory_resource& resource = new_delete_resource()) :
+		_services{detail::resource_allocator<stored>{resource}}
+	{
+		_services.reserve(overrides.size());
+		
+		for (auto const& entry : overrides) {
+			auto const typed_storage = entry.second.template cast<T>();
+			_services.push_back(store(typed_storage.forward(typed_storage.service), std::is_lvalue_reference<service_type<T>>{}));
+		}
+	}
+	
+	auto begin() const noexcept -> iterator {
+		return iterator{const_cast<stored*>(_services.data())};
+	}
+	
+	auto end() const noexcept -> iterator {
+		return iterator{const_cast<stored*>(_services.data() + _services.size())};
+	}
+	
+	auto operator[](size_type const index) const noexcept -> reference {
+		return begin()[static_cast<std::ptrdiff_t>(index)];
+	}
+	
+	auto size() const noexcept -> size_type {
+		return _services.size();
+	}
+	
+	auto empty() const noexcept -> bool {
+		return _services.empty();
+	}
+
+private:
+	std::vector<stored, detail::resource_allocator<stored>> _services;
+};
+
 } // namespace kgr
 
 #endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_RANGE_HPP
@@ -4,6 +4,8 @@
 #include "traits.hpp"
 #include "utils.hpp"
 
+#include <cstring>
+
 namespace kgr {
 namespace detail {
 
@@ -14,6 +16,17 @@ namespace detail {
 template<typename T>
 using forward_ptr = service_type<T>(*)(void*);
 
+/*
+ * Forward function of a single that was forwarded when inserted.
+ * The service pointer of its storage points directly to the forwarded reference.
+ *
+ * Functions calling forward functions often can compare with this one and skip the indirect call.
+ */
+template<typename T>
+auto forward_reference(void* service) noexcept -> service_type<T> {
+	return *static_cast<typename std::remove_reference<service_type<T>>::type*>(service);
+}
+
 template<typename T>
 struct forward_storage {
 	forward_ptr<T> forward;
@@ -42,6 +55,8 @@ private:
 	using function_pointer = void*(*)(void*);
 	
 public:
+	service_storage() = default;
+	
 	template<typename T>
 	service_storage(typed_service_storage<T> const& storage) noexcept : _service{storage.service} {
 		static_assert(sizeof(function_pointer) >= sizeof(forward_storage<T>), "The forward storage size exceed the size of a function pointer");
@@ -80,15 +95,38 @@ public:
 		};
 	}
 	
+	/*
+	 * Returns true for a value initialized storage, which contains no service.
+	 */
+	inline auto empty() const noexcept -> bool {
+		return _service == nullptr;
+	}
+	
 	inline auto index() const noexcept -> std::size_t {
 		return *static_cast<std::size_t const*>(static_cast<void const*>(&forward_function));
 	}
 	
+	/*
+	 * Two storages are equal when they contain the same service with the same forward function.
+	 */
+	friend auto operator==(service_storage const& lhs, service_storage const& rhs) noexcept -> bool {
+		return lhs._service == rhs._service && std::memcmp(lhs.forward_function, rhs.forward_function, sizeof(function_pointer)) == 0;
+	}
+	
+	friend auto operator!=(service_storage const& lhs, service_storage const& rhs) noexcept -> bool {
+		return !(lhs == rhs);
+	}
+
 private:
 	void* _service;
 	alignas(alignof(function_pointer)) unsigned char forward_function[sizeof(function_pointer)];
 };
 
+/*
+ * Tag type to tell memory_block to default construct the service and call its emplace function
+ */
+struct deferred_emplace_t {} constexpr deferred_emplace{};
+
 /*
  * A non moveable and non copyable type wrapper for a service
  *
@@ -109,6 +147,11 @@ struct memory_block {
 	explicit memory_block(Args&&... args) noexcept(noexcept(T{std::forward<Args>(args)...})) :
 		service{std::forward<Args>(args)...} {}
 	
+	template<typename... Args>
+	explicit memory_block(deferred_emplace_t, Args&&... args) : service() {
+		service.emplace(std::forward<Args>(args)...);
+	}
+	
 	T service;
 };
 
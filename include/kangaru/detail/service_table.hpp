@@ -0,0 +1,397 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_TABLE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_TABLE_HPP
+
+#include "key_scan.hpp"
+#include "service_storage.hpp"
+
+#include "../type_id.hpp"
+#include "../memory_resource.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Returns a well distributed hash for a type id.
+ *
+ * Type ids are either addresses of static data, which are close to each other, or hashes
+ * that we don't want to trust too much. Fibonacci hashing spreads them over the upper bits.
+ */
+inline auto hash_type_id(type_id_t const id) noexcept -> std::uint64_t {
+	return type_id_bits(id) * std::uint64_t{0x9E3779B97F4A7C15};
+}
+
+/*
+ * Open addressing hash table that maps type ids to service storage.
+ *
+ * Up to `small_capacity` services are stored inline and searched linearly, so small tables, like the ones
+ * of forks that construct a few services, never allocate. The inline keys are packed, so several of them
+ * are compared at once using vector instructions when available.
+ *
+ * Past that, keys and values are stored in two arrays of the same power of two size, placed in a single allocation.
+ * Probing only reads the array of keys, so a cache line holds eight candidates, and the storage
+ * is read once the key is found. Collisions are resolved using linear probing.
+ * Services are never removed individually from the container, so the table don't need tombstones.
+ *
+ * The kind of each service is encoded in its type id, so no other tag is stored next to the storage.
+ * A default constructed type id is never a valid key, so it marks empty slots.
+ */
+struct service_table {
+	using value_type = std::pair<type_id_t, service_storage>;
+
+private:
+	static_assert(alignof(type_id_t) <= alignof(service_storage), "Keys must be aligned when placed after the storages");
+	
+	static constexpr std::size_t slot_size = sizeof(type_id_t) + sizeof(service_storage);
+	
+	template<typename Storage>
+	struct basic_iterator {
+		using value_type = service_table::value_type;
+		using reference = std::pair<type_id_t, Storage&>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		
+		struct pointer {
+			auto operator->() noexcept -> reference* {
+				return &entry;
+			}
+			
+			reference entry;
+		};
+		
+		explicit basic_iterator(type_id_t const* keys, Storage* values, std::size_t index, std::size_t capacity) noexcept :
+			_keys{keys}, _values{values}, _index{index}, _capacity{capacity}
+		{
+			skip_empty();
+		}
+		
+		friend auto operator==(basic_iterator const& lhs, basic_iterator const& rhs) noexcept -> bool {
+			return lhs._index == rhs._index;
+		}
+		
+		friend auto operator!=(basic_iterator const& lhs, basic_iterator const& rhs) noexcept -> bool {
+			return lhs._index != rhs._index;
+		}
+		
+		auto operator++() noexcept -> basic_iterator& {
+			++_index;
+			skip_empty();
+			return *this;
+		}
+		
+		auto operator++(int) noexcept -> basic_iterator {
+			auto prev = *this;
+			++*this;
+			return prev;
+		}
+		
+		auto operator*() const noexcept -> reference {
+			return reference{_keys[_index], _values[_index]};
+		}
+		
+		auto operator->() const noexcept -> pointer {
+			return pointer{**this};
+		}
+	
+	private:
+		void skip_empty() noexcept {
+			while (_index != _capacity && _keys[_index] == type_id_t{}) {
+				++_index;
+			}
+		}
+		
+		type_id_t const* _keys;
+		Storage* _values;
+		std::size_t _index;
+		std::size_t _capacity;
+	};
+
+public:
+	using iterator = basic_iterator<service_storage>;
+	using const_iterator = basic_iterator<service_storage const>;
+	
+	/*
+	 * Number of services kept inline, before the table allocates.
+	 */
+	static constexpr std::size_t small_capacity = 8;
+	
+	service_table() = default;
+	explicit service_table(memory_resource& resource) noexcept : _resource{&resource} {}
+	
+	service_table(service_table const& other) : _resource{other._resource} {
+		*this = other;
+	}
+	
+	service_table& operator=(service_table const& other) {
+		if (this != &other) {
+			clear();
+			reserve(other._size);
+			
+			for (auto const& entry : other) {
+				emplace(entry.first, entry.second);
+			}
+		}
+		
+		return *this;
+	}
+	
+	service_table(service_table&& other) noexcept {
+		steal(other);
+	}
+	
+	service_table& operator=(service_table&& other) noexcept {
+		if (this != &other) {
+			clear();
+			steal(other);
+		}
+		
+		return *this;
+	}
+	
+	~service_table() {
+		clear();
+	}
+	
+	/*
+	 * Returns a pointer to the storage associated with the id, or null if not found.
+	 */
+	auto find(type_id_t const id) noexcept -> service_storage* {
+		return const_cast<service_storage*>(static_cast<service_table const&>(*this).find(id));
+	}
+	
+	auto find(type_id_t const id) const noexcept -> service_storage const* {
+		if (_capacity == 0) {
+			auto const index = find_key(_small_keys, _size, id);
+			return index != _size ? _small_values + index : nullptr;
+		}
+		
+		auto const mask = _capacity - 1;
+		auto index = static_cast<std::size_t>(hash_type_id(id) >> 32) & mask;
+		
+		while (true) {
+			auto const key = _keys[index];
+			
+			if (key == id) return _values + index;
+			if (key == type_id_t{}) return nullptr;
+			
+			index = (index + 1) & mask;
+		}
+	}
+	
+	auto contains(type_id_t const id) const noexcept -> bool {
+		return find(id) != nullptr;
+	}
+	
+	/*
+	 * Inserts the storage if the id is not already in the table.
+	 * Returns the storage associated with the id and whether the insertion took place.
+	 */
+	auto emplace(type_id_t const id, service_storage const& storage) -> std::pair<service_storage*, bool> {
+		reserve(_size + 1);
+		
+		auto const found = slot(id);
+		
+		if (*found.first == id) {
+			return {found.second, false};
+		}
+		
+		*found.first = id;
+		*found.second = storage;
+		++_size;
+		
+		return {found.second, true};
+	}
+	
+	/*
+	 * Inserts the storage, or replace the existing one associated with the id.
+	 */
+	auto insert_or_assign(type_id_t const id, service_storage const& storage) -> service_storage& {
+		reserve(_size + 1);
+		
+		auto const found = slot(id);
+		
+		if (*found.first != id) {
+			*found.first = id;
+			++_size;
+		}
+		
+		*found.second = storage;
+		return *found.second;
+	}
+	
+	/*
+	 * Makes enough room to contain `size` services without growing.
+	 * Up to `small_capacity` services are kept inline and searched linearly.
+	 * Past that, since probing only reads keys, the table can be kept up to three quarters full.
+	 */
+	void reserve(std::size_t const size) {
+		if (size > small_capacity && size * 4 > _capacity * 3) {
+			auto capacity = _capacity == 0 ? std::size_t{16} : _capacity * 2;
+			
+			while (size * 4 > capacity * 3) {
+				capacity *= 2;
+			}
+			
+			rehash(capacity);
+		}
+	}
+	
+	void clear() noexcept {
+		if (_capacity != 0) {
+			_resource->deallocate(_values, _capacity * slot_size, alignof(service_storage));
+		}
+		
+		release();
+	}
+	
+	auto size() const noexcept -> std::size_t {
+		return _size;
+	}
+	
+	auto empty() const noexcept -> bool {
+		return _size == 0;
+	}
+	
+	/*
+	 * Returns the number of bytes allocated by the table. Services kept inline don't allocate.
+	 */
+	auto memory_usage() const noexcept -> std::size_t {
+		return _capacity * slot_size;
+	}
+	
+	auto begin() noexcept -> iterator {
+		return _capacity == 0
+			? iterator{_small_keys, _small_values, 0, _size}
+			: iterator{_keys, _values, 0, _capacity};
+	}
+	
+	auto end() noexcept -> iterator {
+		return _capacity == 0
+			? iterator{_small_keys, _small_values, _size, _size}
+			: iterator{_keys, _values, _capacity, _capacity};
+	}
+	
+	auto begin() const noexcept -> const_iterator {
+		return _capacity == 0
+			? const_iterator{_small_keys, _small_values, 0, _size}
+			: const_iterator{_keys, _values, 0, _capacity};
+	}
+	
+	auto end() const noexcept -> const_iterator {
+		return _capacity == 0
+			? const_iterator{_small_keys, _small_values, _size, _size}
+			: const_iterator{_keys, _values, _capacity, _capacity};
+	}
+
+private:
+	/*
+	 * Returns the key equal to the id and its storage, or the empty key where it should be inserted.
+	 * There must be room for one more service.
+	 */
+	auto slot(type_id_t const id) noexcept -> std::pair<type_id_t*, service_storage*> {
+		if (_capacity == 0) {
+			auto const index = find_key(_small_keys, _size, id);
+			
+			// The inline keys past the size are left from previous services
+			if (index == _size) {
+				_small_keys[index] = type_id_t{};
+			}
+			
+			return {_small_keys + index, _small_values + index};
+		}
+		
+		auto& key = probe(id);
+		return {&key, _values + (&key - _keys)};
+	}
+	
+	/*
+	 * Returns the key equal to the id, or the empty key where it should be inserted.
+	 * The table must have allocated its slots.
+	 */
+	auto probe(type_id_t const id) noexcept -> type_id_t& {
+		auto const mask = _capacity - 1;
+		auto index = static_cast<std::size_t>(hash_type_id(id) >> 32) & mask;
+		
+		while (_keys[index] != id && _keys[index] != type_id_t{}) {
+			index = (index + 1) & mask;
+		}
+		
+		return _keys[index];
+	}
+	
+	/*
+	 * Moves every service to newly allocated slots. Services kept inline are moved out of the table.
+	 */
+	void rehash(std::size_t const capacity) {
+		auto const old_values = _capacity == 0 ? _small_values : _values;
+		auto const old_keys = _capacity == 0 ? _small_keys : _keys;
+		auto const old_capacity = _capacity == 0 ? _size : _capacity;
+		auto const allocated = _capacity * slot_size;
+		
+		auto const memory = _resource->allocate(capacity * slot_size, alignof(service_storage));
+		_values = ::new (memory) service_storage[capacity]();
+		_keys = ::new (static_cast<void*>(_values + capacity)) type_id_t[capacity]();
+		_capacity = capacity;
+		
+		for (std::size_t index = 0 ; index < old_capacity ; ++index) {
+			if (old_keys[index] != type_id_t{}) {
+				auto& key = probe(old_keys[index]);
+				key = old_keys[index];
+				_values[&key - _keys] = old_values[index];
+			}
+		}
+		
+		if (allocated != 0) {
+			_resource->deallocate(old_values, allocated, alignof(service_storage));
+		}
+	}
+	
+	/*
+	 * Takes the services of the other table, which is left empty.
+	 */
+	void steal(service_table& other) noexcept {
+		_resource = other._resource;
+		_size = other._size;
+		
+		if (other._capacity == 0) {
+			std::copy(other._small_keys, other._small_keys + other._size, _small_keys);
+			std::copy(other._small_values, other._small_values + other._size, _small_values);
+		} else {
+			_values = other._values;
+			_keys = other._keys;
+			_capacity = other._capacity;
+		}
+		
+		other.release();
+	}
+	
+	void release() noexcept {
+		_values = nullptr;
+		_keys = nullptr;
+		_capacity = 0;
+		_size = 0;
+	}
+	
+	service_storage* _values = nullptr;
+	type_id_t* _keys = nullptr;
+	std::size_t _capacity = 0;
+	std::size_t _size = 0;
+	memory_resource* _resource = &new_delete_resource();
+	
+	// Services kept inline while there is at most `small_capacity` of them, packed in insertion order.
+	// Only the first `_size` slots are valid. The keys are all initialized since they are compared a block at a time,
+	// but the storages are not, so constructing and moving a table stays cheap.
+	type_id_t _small_keys[small_capacity] = {};
+	service_storage _small_values[small_capacity];
+};
+
+} // namespace detail
+} // namespace kgr
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_SERVICE_TABLE_HPP
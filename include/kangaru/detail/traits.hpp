@@ -19,6 +19,9 @@ namespace kgr {
  */
 using in_place_t = decltype(detail::in_place);
 
+template<typename, typename>
+struct single_service;
+
 namespace detail {
 
 /**
@@ -30,6 +33,22 @@ using forward_t = decltype(std::declval<T>().forward());
 template<typename T>
 using has_forward = bool_constant<!std::is_void<detected_or<void, forward_t, T>>::value>;
 
+template<typename>
+struct is_single_service_definition : std::false_type {};
+
+template<typename Type, typename Deps>
+struct is_single_service_definition<single_service<Type, Deps>> : std::true_type {};
+
+/*
+ * Trait that tells if the forward function of a service is the one of kgr::single_service.
+ * That function returns the same reference each time, and does nothing else.
+ */
+template<typename T, typename = void>
+struct has_single_service_forward : std::false_type {};
+
+template<typename T>
+struct has_single_service_forward<T, void_t<decltype(&T::forward)>> : is_single_service_definition<object_type_t<decltype(&T::forward)>> {};
+
 
 // Workaround for visual studio to take the address of a generic lambda
 template<typename T>
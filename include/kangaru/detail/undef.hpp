@@ -12,6 +12,9 @@
 #undef KGR_KANGARU_FUNCTION_SIGNATURE
 #undef KGR_KANGARU_NONCONST_TYPEID
 #undef KGR_KANGARU_HASH_EXTENDED_CONSTEXPR
+#undef KGR_KANGARU_KEY_SCAN_AVX2
+#undef KGR_KANGARU_KEY_SCAN_SSE2
+#undef KGR_KANGARU_KEY_SCAN_NEON
 
 // These two header are meant to be included
 // everytime they are needed since they cancel each other
@@ -0,0 +1,108 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_DETAIL_WARMUP_SCHEDULE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_DETAIL_WARMUP_SCHEDULE_HPP
+
+#include "../type_id.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "define.hpp"
+
+namespace kgr {
+
+struct container;
+
+namespace detail {
+
+/*
+ * A single to construct during a warmup, with the indices of the nodes that must be constructed before it.
+ * Sequential nodes inject the container, so they are constructed by the thread driving the warmup.
+ */
+struct warmup_node {
+	type_id_t id;
+	void(*construct)(container&);
+	bool sequential;
+	std::vector<std::size_t> dependencies;
+};
+
+/*
+ * State shared by the tasks of a warmup.
+ * Every member is guarded by the mutex.
+ */
+struct warmup_schedule {
+	explicit warmup_schedule(std::vector<warmup_node> graph) :
+		nodes{std::move(graph)}, pending(nodes.size()), dependents(nodes.size()), done(nodes.size()), remaining{nodes.size()}
+	{
+		for (std::size_t index = 0 ; index < nodes.size() ; ++index) {
+			pending[index] = nodes[index].dependencies.size();
+			
+			for (auto const dependency : nodes[index].dependencies) {
+				dependents[dependency].push_back(index);
+			}
+		}
+	}
+	
+	/*
+	 * Completes the nodes the predicate returns true for, then queues the nodes that don't wait for anything.
+	 * Completing a node already queues its dependents that are ready.
+	 */
+	template<typename F>
+	void start(F is_present) {
+		for (std::size_t index = 0 ; index < nodes.size() ; ++index) {
+			if (!done[index] && is_present(nodes[index].id)) {
+				complete(index);
+			}
+		}
+		
+		for (std::size_t index = 0 ; index < nodes.size() ; ++index) {
+			if (!done[index] && nodes[index].dependencies.empty()) {
+				ready.push_back(index);
+			}
+		}
+	}
+	
+	/*
+	 * Marks a node as constructed, and queues the nodes that were only waiting for it.
+	 */
+	void complete(std::size_t const index) {
+		done[index] = true;
+		--remaining;
+		
+		for (auto const dependent : dependents[index]) {
+			if (--pending[dependent] == 0 && !done[dependent]) {
+				ready.push_back(dependent);
+			}
+		}
+	}
+	
+	auto take() -> std::size_t {
+		auto const index = ready.back();
+		ready.pop_back();
+		return index;
+	}
+	
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::vector<warmup_node> nodes;
+	std::vector<std::size_t> pending;
+	std::vector<std::vector<std::size_t>> dependents;
+	std::vector<bool> done;
+	std::vector<std::size_t> ready;
+	std::size_t remaining;
+	std::size_t in_flight = 0;
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+	std::exception_ptr error;
+#endif
+};
+
+} // namespace detail
+} // namespace kgr
+
+#include "undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_DETAIL_WARMUP_SCHEDULE_HPP
@@ -0,0 +1,217 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_FROZEN_CONTAINER_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_FROZEN_CONTAINER_HPP
+
+#include "container.hpp"
+#include "detail/frozen_service_table.hpp"
+#include "detail/service_table.hpp"
+#include "detail/traits.hpp"
+#include "detail/utils.hpp"
+#include "detail/injected.hpp"
+#include "detail/service_storage.hpp"
+#include "detail/error.hpp"
+#include "memory_resource.hpp"
+#include "predicate.hpp"
+#include "type_id.hpp"
+
+#include <type_traits>
+
+#include "detail/define.hpp"
+
+namespace kgr {
+
+/**
+ * A container whose services were frozen after startup.
+ *
+ * Every service of the container it is made from is placed in a table with a perfect hash,
+ * so a frozen single is found by comparing a single key, without probing nor filling any cache.
+ * The frozen services never change. Constructing new singles and services that are not single
+ * is done in a mutable child, a fork of the frozen services.
+ */
+struct frozen_container {
+private:
+	template<typename Condition, typename T = int> using enable_if = detail::enable_if_t<Condition::value, T>;
+	template<typename Condition, typename T = int> using disable_if = detail::enable_if_t<!Condition::value, T>;
+
+public:
+	/*
+	 * Constructs a frozen container that contains the services of an existing container.
+	 */
+	explicit frozen_container(container&& other) :
+		_container{std::move(other)},
+		_frozen{visible_services(_container), _container.resource()},
+		_child{_container.fork()} {}
+	
+	frozen_container(frozen_container const&) = delete;
+	frozen_container& operator=(frozen_container const&) = delete;
+	frozen_container(frozen_container&&) = default;
+	frozen_container& operator=(frozen_container&&) = default;
+	
+	/*
+	 * This function returns the service given by service definition T.
+	 * Frozen singles are returned from the frozen table.
+	 * Other services are returned by the child container, which constructs them if needed.
+	 */
+	template<typename T, typename... Args, enable_if<detail::is_service_valid<T, Args...>> = 0>
+	auto service(Args&&... args) -> service_type<T> {
+		return definition<T>(std::forward<Args>(args)...).forward();
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, typename... Args>
+	auto service(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) -> detail::sink = delete;
+	
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	auto service(detail::service_error<T> = {}) -> detail::sink = delete;
+	
+	/*
+	 * This function returns the result of the callable object of type U.
+	 * Args are additional arguments to be sent to the function after services arguments.
+	 * This function will deduce arguments from the function signature.
+	 */
+	template<typename Map = map<>, typename U, typename... Args,
+		enable_if<detail::is_map<Map>> = 0,
+		enable_if<detail::is_invoke_valid<Map, detail::decay_t<U>, Args...>> = 0>
+	auto invoke(U&& function, Args&&... args) -> detail::invoke_function_result_t<Map, detail::decay_t<U>, Args...> {
+		return invoke_helper<Map>(
+			detail::tuple_seq_minus<detail::invoke_function_arguments_t<Map, detail::decay_t<U>, Args...>, sizeof...(Args)>{},
+			std::forward<U>(function),
+			std::forward<Args>(args)...
+		);
+	}
+	
+	/*
+	 * This function returns the result of the callable object of type U.
+	 * It will call the function with the sevices listed in the `Services` parameter pack.
+	 */
+	template<typename First, typename... Services, typename U, typename... Args, enable_if<detail::conjunction<
+		detail::is_service_valid<First>,
+		detail::is_service_valid<Services>...>> = 0>
+	auto invoke(U&& function, Args&&... args)
+		-> detail::call_result_t<U, service_type<First>, service_type<Services>..., Args...>
+	{
+		return std::forward<U>(function)(service<First>(), service<Services>()..., std::forward<Args>(args)...);
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container sees the frozen services and the ones constructed by the child container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate type as template argument.
+	 * The default predicate is kgr::all.
+	 */
+	template<typename Predicate = all, detail::enable_if_t<std::is_default_constructible<Predicate>::value, int> = 0>
+	auto fork() const -> container {
+		return _child.fork(Predicate{});
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container sees the frozen services and the ones constructed by the child container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate as argument.
+	 */
+	template<typename Predicate, disable_if<std::is_base_of<memory_resource, Predicate>> = 0>
+	auto fork(Predicate predicate) const -> container {
+		return _child.fork(predicate);
+	}
+	
+	/*
+	 * This function return true if the container contains the service T. Returns false otherwise.
+	 * T nust be a single service.
+	 */
+	template<typename T, detail::enable_if_t<detail::is_service<T>::value && detail::is_single<T>::value, int> = 0>
+	bool contains() const {
+		return _frozen.contains(type_id<T>()) || _child.contains<T>();
+	}
+	
+	/*
+	 * This function returns the memory resource used by this container for all its allocations.
+	 */
+	auto resource() const noexcept -> memory_resource& {
+		return _container.resource();
+	}
+
+private:
+	/*
+	 * Collects every service visible from the container, which the frozen table is built from.
+	 */
+	static auto visible_services(container& frozen) -> detail::service_table {
+		detail::service_table services{frozen.resource()};
+		
+		frozen.source().for_each_visible([&](type_id_t id, detail::service_storage const& storage) {
+			services.emplace(id, storage);
+		});
+		
+		return services;
+	}
+	
+	///////////////////////
+	//    definition     //
+	///////////////////////
+	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function returns a frozen single, or constructs it in the child if it was not frozen.
+	 * A polymorphic single is found in the child once the child inserted an override of it.
+	 */
+	template<typename T, enable_if<detail::is_single<T>> = 0>
+	auto definition() -> detail::injected_wrapper<T> {
+		auto const id = type_id<T>();
+		
+		if (!detail::is_polymorphic<T>::value || !_child.source().owns(id)) {
+			if (auto const storage = _frozen.find(id)) {
+				auto service = *storage;
+				return detail::injected_wrapper<T>{service};
+			}
+		}
+		
+		return _child.definition<T>();
+	}
+	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function is for services that are not single, which are constructed by the child.
+	 */
+	template<typename T, typename... Args, disable_if<detail::is_single<T>> = 0>
+	auto definition(Args&&... args) -> detail::injected_wrapper<T> {
+		return _child.definition<T>(std::forward<Args>(args)...);
+	}
+	
+	///////////////////////
+	//      invoke       //
+	///////////////////////
+	
+	/*
+	 * This function is an helper for the public invoke function.
+	 * It unpacks arguments of the function with an integer sequence.
+	 */
+	template<typename Map, typename U, typename... Args, std::size_t... S>
+	auto invoke_helper(detail::seq<S...>, U&& function, Args&&... args)
+		-> detail::invoke_function_result_t<Map, detail::decay_t<U>, Args...>
+	{
+		return std::forward<U>(function)(
+			service<mapped_service_t<detail::invoke_function_argument_t<S, Map, detail::decay_t<U>, Args...>, Map>>()...,
+			std::forward<Args>(args)...
+		);
+	}
+	
+	container _container;
+	detail::frozen_service_table _frozen;
+	container _child;
+};
+
+inline auto container::freeze() const -> frozen_container {
+	return frozen_container{fork()};
+}
+
+} // namespace kgr
+
+#include "detail/undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_FROZEN_CONTAINER_HPP
@@ -3,14 +3,20 @@
 
 #include "autocall.hpp"
 #include "autowire.hpp"
+#include "concurrent_container.hpp"
 #include "container.hpp"
+#include "dependency_graph.hpp"
+#include "frozen_container.hpp"
 #include "generic.hpp"
+#include "memory_resource.hpp"
 #include "operator.hpp"
 #include "operator_service.hpp"
 #include "optional.hpp"
+#include "parallel_for_each.hpp"
 #include "predicate.hpp"
 #include "debug.hpp"
 #include "service.hpp"
+#include "static_container.hpp"
 #include "type_id.hpp"
 
 #endif // KGR_KANGARU_INCLUDE_KANGARU_KANGARU_HPP
@@ -0,0 +1,276 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_MEMORY_RESOURCE_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && (__cplusplus >= 201703L || _MSVC_LANG >= 201703L)
+#include <memory_resource>
+#define KGR_KANGARU_HAS_STD_MEMORY_RESOURCE
+#endif
+#endif
+
+namespace kgr {
+
+/*
+ * Interface to a source of memory used by the container.
+ *
+ * It is modeled after std::pmr::memory_resource, which is not available in C++11.
+ * Every allocation made by a container goes through its memory resource.
+ */
+struct memory_resource {
+	memory_resource() = default;
+	memory_resource(memory_resource const&) = default;
+	memory_resource& operator=(memory_resource const&) = default;
+	virtual ~memory_resource() = default;
+	
+	auto allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) -> void* {
+		return do_allocate(bytes, alignment);
+	}
+	
+	void deallocate(void* memory, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+		do_deallocate(memory, bytes, alignment);
+	}
+	
+	auto is_equal(memory_resource const& other) const noexcept -> bool {
+		return do_is_equal(other);
+	}
+
+private:
+	virtual auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* = 0;
+	virtual void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) = 0;
+	
+	virtual auto do_is_equal(memory_resource const& other) const noexcept -> bool {
+		return this == &other;
+	}
+};
+
+namespace detail {
+
+/*
+ * Memory resource that uses the global operator new and operator delete.
+ *
+ * Alignments greater than the one of max_align_t are handled by over allocating
+ * and storing the original pointer just before the aligned block.
+ */
+struct new_delete_memory_resource final : memory_resource {
+private:
+	static constexpr std::size_t default_alignment = alignof(std::max_align_t);
+	
+	auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+		if (alignment <= default_alignment) {
+			return ::operator new(bytes);
+		}
+		
+		auto const memory = ::operator new(bytes + alignment + sizeof(void*));
+		auto const address = reinterpret_cast<std::uintptr_t>(memory) + sizeof(void*);
+		auto const aligned = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+		
+		reinterpret_cast<void**>(aligned)[-1] = memory;
+		
+		return reinterpret_cast<void*>(aligned);
+	}
+	
+	void do_deallocate(void* memory, std::size_t, std::size_t alignment) override {
+		if (alignment <= default_alignment) {
+			::operator delete(memory);
+		} else {
+			::operator delete(static_cast<void**>(memory)[-1]);
+		}
+	}
+};
+
+} // namespace detail
+
+/*
+ * Returns the memory resource used by containers by default.
+ *
+ * It uses the global operator new and operator delete.
+ */
+inline auto new_delete_resource() noexcept -> memory_resource& {
+	static detail::new_delete_memory_resource resource;
+	return resource;
+}
+
+/*
+ * Memory resource that only releases its memory when destroyed or when calling release.
+ *
+ * Allocations are made by bumping a pointer into a buffer that grows geometrically.
+ * An initial buffer can be supplied, in which case no allocations are done until it's full.
+ * This is useful to give a forked container all the memory it needs, and drop it at once.
+ */
+struct monotonic_buffer_resource : memory_resource {
+	explicit monotonic_buffer_resource(memory_resource& upstream = new_delete_resource()) noexcept :
+		_upstream{&upstream} {}
+	
+	explicit monotonic_buffer_resource(std::size_t initial_size, memory_resource& upstream = new_delete_resource()) noexcept :
+		_upstream{&upstream}, _next_size{initial_size > minimum_size ? initial_size : std::size_t{minimum_size}} {}
+	
+	explicit monotonic_buffer_resource(void* buffer, std::size_t size, memory_resource& upstream = new_delete_resource()) noexcept :
+		_upstream{&upstream},
+		_current{static_cast<unsigned char*>(buffer)},
+		_remaining{size},
+		_next_size{size > minimum_size ? size : std::size_t{minimum_size}},
+		_initial_buffer{static_cast<unsigned char*>(buffer)},
+		_initial_size{size} {}
+	
+	monotonic_buffer_resource(monotonic_buffer_resource const&) = delete;
+	monotonic_buffer_resource& operator=(monotonic_buffer_resource const&) = delete;
+	
+	~monotonic_buffer_resource() {
+		release();
+	}
+	
+	/*
+	 * Gives back all the memory allocated from the upstream resource.
+	 * Every allocation made from this resource is invalidated.
+	 */
+	void release() noexcept {
+		while (_chunks) {
+			auto const chunk = _chunks;
+			_chunks = chunk->next;
+			_upstream->deallocate(chunk, chunk->size, alignof(chunk_header));
+		}
+		
+		_current = _initial_buffer;
+		_remaining = _initial_size;
+	}
+	
+	auto upstream_resource() const noexcept -> memory_resource& {
+		return *_upstream;
+	}
+
+private:
+	static constexpr std::size_t minimum_size = 1024;
+	
+	struct chunk_header {
+		chunk_header* next;
+		std::size_t size;
+	};
+	
+	auto bump(std::size_t bytes, std::size_t alignment) noexcept -> void* {
+		auto const address = reinterpret_cast<std::uintptr_t>(_current);
+		auto const aligned = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+		auto const padding = static_cast<std::size_t>(aligned - address);
+		
+		if (_current == nullptr || padding + bytes > _remaining) {
+			return nullptr;
+		}
+		
+		_current += padding + bytes;
+		_remaining -= padding + bytes;
+		
+		return reinterpret_cast<void*>(aligned);
+	}
+	
+	auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+		if (auto const memory = bump(bytes, alignment)) {
+			return memory;
+		}
+		
+		auto size = _next_size;
+		
+		while (size < bytes + alignment + sizeof(chunk_header)) {
+			size *= 2;
+		}
+		
+		auto const chunk = static_cast<chunk_header*>(_upstream->allocate(size, alignof(chunk_header)));
+		chunk->next = _chunks;
+		chunk->size = size;
+		
+		_chunks = chunk;
+		_current = reinterpret_cast<unsigned char*>(chunk + 1);
+		_remaining = size - sizeof(chunk_header);
+		_next_size = size * 2;
+		
+		return bump(bytes, alignment);
+	}
+	
+	void do_deallocate(void*, std::size_t, std::size_t) override {}
+	
+	memory_resource* _upstream;
+	unsigned char* _current = nullptr;
+	std::size_t _remaining = 0;
+	std::size_t _next_size = minimum_size;
+	chunk_header* _chunks = nullptr;
+	unsigned char* _initial_buffer = nullptr;
+	std::size_t _initial_size = 0;
+};
+
+#ifdef KGR_KANGARU_HAS_STD_MEMORY_RESOURCE
+
+/*
+ * Adapts a std::pmr::memory_resource to be used by containers.
+ */
+struct pmr_resource_adaptor final : memory_resource {
+	explicit pmr_resource_adaptor(std::pmr::memory_resource& resource) noexcept : _resource{&resource} {}
+
+private:
+	auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+		return _resource->allocate(bytes, alignment);
+	}
+	
+	void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override {
+		_resource->deallocate(memory, bytes, alignment);
+	}
+	
+	std::pmr::memory_resource* _resource;
+};
+
+#endif // KGR_KANGARU_HAS_STD_MEMORY_RESOURCE
+
+namespace detail {
+
+/*
+ * Standard allocator that allocates from a memory resource.
+ *
+ * It is used for all the internal data structures of the container.
+ * The resource follows the container when moved or swapped.
+ */
+template<typename T>
+struct resource_allocator {
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	
+	resource_allocator() noexcept : _resource{&new_delete_resource()} {}
+	resource_allocator(memory_resource& resource) noexcept : _resource{&resource} {}
+	
+	template<typename U>
+	resource_allocator(resource_allocator<U> const& other) noexcept : _resource{&other.resource()} {}
+	
+	auto allocate(std::size_t n) -> T* {
+		return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+	}
+	
+	void deallocate(T* memory, std::size_t n) noexcept {
+		_resource->deallocate(memory, n * sizeof(T), alignof(T));
+	}
+	
+	auto resource() const noexcept -> memory_resource& {
+		return *_resource;
+	}
+	
+	template<typename U>
+	friend auto operator==(resource_allocator const& lhs, resource_allocator<U> const& rhs) noexcept -> bool {
+		return lhs._resource == &rhs.resource() || lhs._resource->is_equal(rhs.resource());
+	}
+	
+	template<typename U>
+	friend auto operator!=(resource_allocator const& lhs, resource_allocator<U> const& rhs) noexcept -> bool {
+		return !(lhs == rhs);
+	}
+
+private:
+	memory_resource* _resource;
+};
+
+} // namespace detail
+} // namespace kgr
+
+#undef KGR_KANGARU_HAS_STD_MEMORY_RESOURCE
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_MEMORY_RESOURCE_HPP
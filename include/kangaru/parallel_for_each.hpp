@@ -0,0 +1,122 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_PARALLEL_FOR_EACH_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_PARALLEL_FOR_EACH_HPP
+
+#include "container.hpp"
+#include "detail/for_each_schedule.hpp"
+#include "detail/override_range_service.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "detail/define.hpp"
+
+namespace kgr {
+namespace detail {
+
+/*
+ * Calls the function with the overrides of every chunk it can take from the schedule.
+ * The first exception stops the other threads from taking new chunks.
+ */
+template<typename View, typename Function>
+void for_each_chunks(for_each_schedule& schedule, View const& view, Function& function) {
+	std::size_t begin, end;
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+	try {
+		while (schedule.take(begin, end)) {
+			for (auto index = begin ; index < end ; ++index) {
+				function(view[index]);
+			}
+		}
+	} catch (...) {
+		schedule.stop();
+		
+		std::lock_guard<std::mutex> lock{schedule.mutex};
+		if (!schedule.error) {
+			schedule.error = std::current_exception();
+		}
+	}
+#else
+	while (schedule.take(begin, end)) {
+		for (auto index = begin ; index < end ; ++index) {
+			function(view[index]);
+		}
+	}
+#endif
+}
+
+/*
+ * A task given to the executor of a parallel for each, which processes chunks until there is none left.
+ *
+ * The task shares the ownership of the schedule, as it may be called after the parallel for each returned.
+ * The view and the function are only used while the task is busy, and the calling thread waits for busy tasks.
+ */
+template<typename View, typename Function>
+struct for_each_task {
+	std::shared_ptr<for_each_schedule> schedule;
+	View const* view;
+	Function* function;
+	
+	void operator()() const {
+		{
+			std::lock_guard<std::mutex> lock{schedule->mutex};
+			if (!schedule->pending()) return;
+			++schedule->busy;
+		}
+		
+		for_each_chunks(*schedule, *view, *function);
+		
+		std::lock_guard<std::mutex> lock{schedule->mutex};
+		--schedule->busy;
+		schedule->finished.notify_one();
+	}
+};
+
+} // namespace detail
+
+/**
+ * Calls the function with every service overriding T, using the executor to call it from many threads.
+ *
+ * The overrides are forwarded by the calling thread before any task is started, as `override_view_service<T>` does.
+ * The function is then only given services that are already constructed, and the container is not used by other threads.
+ * The function must be safe to call at the same time from many threads, with different services.
+ *
+ * Overrides are split in chunks of `chunk_size` services. Each task, and the calling thread, takes chunks until none are left.
+ * The executor is called with tasks that can run on any thread, late or never:
+ * the calling thread processes the chunks other threads did not take, then waits for the chunks they did take.
+ * The first exception thrown by the function is rethrown once busy tasks are done. Chunks that were not started are skipped.
+ */
+template<typename T, typename Function, typename Executor>
+void parallel_for_each(container& target, Function&& function, Executor&& executor, std::size_t const chunk_size = 1) {
+	using view_t = override_view<T>;
+	using task_t = detail::for_each_task<view_t, typename std::remove_reference<Function>::type>;
+	
+	auto const view = target.service<override_view_service<T>>();
+	auto const schedule = std::make_shared<detail::for_each_schedule>(view.size(), chunk_size);
+	
+	// The calling thread takes chunks too, so one less task is needed
+	for (std::size_t task = 1 ; task < schedule->chunk_count() && schedule->pending() ; ++task) {
+		executor(task_t{schedule, &view, &function});
+	}
+	
+	detail::for_each_chunks(*schedule, view, function);
+	
+	std::unique_lock<std::mutex> lock{schedule->mutex};
+	schedule->finished.wait(lock, [&schedule] { return schedule->busy == 0; });
+
+#ifndef KGR_KANGARU_NOEXCEPTION
+	if (schedule->error) {
+		std::rethrow_exception(schedule->error);
+	}
+#endif
+}
+
+} // namespace kgr
+
+#include "detail/undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_PARALLEL_FOR_EACH_HPP
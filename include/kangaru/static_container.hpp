@@ -0,0 +1,323 @@
+#ifndef KGR_KANGARU_INCLUDE_KANGARU_STATIC_CONTAINER_HPP
+#define KGR_KANGARU_INCLUDE_KANGARU_STATIC_CONTAINER_HPP
+
+#include "container.hpp"
+#include "detail/traits.hpp"
+#include "detail/utils.hpp"
+#include "detail/meta_list.hpp"
+#include "detail/seq.hpp"
+#include "detail/injected.hpp"
+#include "detail/service_storage.hpp"
+#include "detail/error.hpp"
+#include "memory_resource.hpp"
+#include "predicate.hpp"
+#include "type_id.hpp"
+
+#include <tuple>
+#include <type_traits>
+
+#include "detail/define.hpp"
+
+namespace kgr {
+
+/**
+ * A container that knows a list of single services at compile time.
+ *
+ * Each single in `Definitions` gets its own typed slot, which is filled the first time the service is needed.
+ * Once filled, those services are returned directly from their slot, without hashing their type id.
+ *
+ * Services are constructed by an inner container, so dependencies, overrides and autocall work as usual.
+ * Services not listed in `Definitions` are found in the inner container.
+ */
+template<typename... Definitions>
+struct static_container {
+private:
+	template<typename Condition, typename T = int> using enable_if = detail::enable_if_t<Condition::value, T>;
+	template<typename Condition, typename T = int> using disable_if = detail::enable_if_t<!Condition::value, T>;
+	template<typename T> using is_static = detail::meta_list_contains<T, detail::meta_list<Definitions...>>;
+	template<typename T> using slot_index = detail::meta_list_find<T, detail::meta_list<Definitions...>>;
+	using slots_seq = typename detail::seq_gen<sizeof...(Definitions)>::type;
+	using unpack = int[];
+	
+	static_assert(detail::conjunction<detail::is_single<Definitions>...>::value,
+		"Only single services can be stored in the slots of a static container"
+	);
+
+public:
+	explicit static_container() = default;
+	
+	/*
+	 * Constructs a container that makes all its allocations from the memory resource.
+	 * The memory resource must outlive the container.
+	 */
+	explicit static_container(memory_resource& resource) : _container{resource} {}
+	
+	/*
+	 * Constructs a static container that contains the services of an existing container.
+	 * The slots are filled on first use.
+	 */
+	explicit static_container(container&& other) : _container{std::move(other)} {}
+	
+	static_container(static_container const&) = delete;
+	static_container& operator=(static_container const&) = delete;
+	static_container(static_container&&) = default;
+	static_container& operator=(static_container&&) = default;
+	
+	/*
+	 * This function construct and save in place a service definition with the provided arguments.
+	 * The service is only constructed if it is not found.
+	 * It returns if the service has been constructed.
+	 * This function require the service to be single.
+	 */
+	template<typename T, typename... Args,
+		enable_if<detail::is_emplace_valid<T, Args...>> = 0>
+	bool emplace(Args&&... args) {
+		auto const emplaced = _container.emplace<T>(std::forward<Args>(args)...);
+		
+		reset_polymorphic_slots(slots_seq{});
+		
+		return emplaced;
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	bool emplace(detail::service_error<T> = {}) = delete;
+	
+	template<typename T, typename... Args>
+	bool emplace(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) = delete;
+	
+	/*
+	 * This function construct and save in place a service definition with the provided arguments.
+	 * The inserted instance of the service will be used for now on.
+	 * It does not delete the old instance if any.
+	 * This function require the service to be single.
+	 */
+	template<typename T, typename... Args,
+		enable_if<detail::is_emplace_valid<T, Args...>> = 0>
+	void replace(Args&&... args) {
+		_container.replace<T>(std::forward<Args>(args)...);
+		
+		reset_slot<T>();
+		reset_polymorphic_slots(slots_seq{});
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	void replace(detail::service_error<T> = {}) = delete;
+	
+	template<typename T, typename... Args>
+	void replace(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) = delete;
+	
+	/*
+	 * This function returns the service given by service definition T.
+	 * Services listed in `Definitions` are returned from their slot once constructed.
+	 * Other services are returned by the inner container.
+	 */
+	template<typename T, typename... Args, enable_if<detail::is_service_valid<T, Args...>> = 0>
+	auto service(Args&&... args) -> service_type<T> {
+		return definition<T>(std::forward<Args>(args)...).forward();
+	}
+	
+	/*
+	 * The following two overloads are called in a case where the service is invalid,
+	 * or is called when provided arguments don't match the constructor.
+	 * In GCC, a diagnostic is provided.
+	 */
+	template<typename T, typename... Args>
+	auto service(detail::service_error<T, detail::identity_t<Args>...>, Args&&...) -> detail::sink = delete;
+	
+	template<typename T, enable_if<std::is_default_constructible<detail::service_error<T>>> = 0>
+	auto service(detail::service_error<T> = {}) -> detail::sink = delete;
+	
+	/*
+	 * This function returns the result of the callable object of type U.
+	 * Args are additional arguments to be sent to the function after services arguments.
+	 * This function will deduce arguments from the function signature.
+	 */
+	template<typename Map = map<>, typename U, typename... Args,
+		enable_if<detail::is_map<Map>> = 0,
+		enable_if<detail::is_invoke_valid<Map, detail::decay_t<U>, Args...>> = 0>
+	auto invoke(U&& function, Args&&... args) -> detail::invoke_function_result_t<Map, detail::decay_t<U>, Args...> {
+		return invoke_helper<Map>(
+			detail::tuple_seq_minus<detail::invoke_function_arguments_t<Map, detail::decay_t<U>, Args...>, sizeof...(Args)>{},
+			std::forward<U>(function),
+			std::forward<Args>(args)...
+		);
+	}
+	
+	/*
+	 * This function returns the result of the callable object of type U.
+	 * It will call the function with the sevices listed in the `Services` parameter pack.
+	 */
+	template<typename First, typename... Services, typename U, typename... Args, enable_if<detail::conjunction<
+		detail::is_service_valid<First>,
+		detail::is_service_valid<Services>...>> = 0>
+	auto invoke(U&& function, Args&&... args)
+		-> detail::call_result_t<U, service_type<First>, service_type<Services>..., Args...>
+	{
+		return std::forward<U>(function)(service<First>(), service<Services>()..., std::forward<Args>(args)...);
+	}
+	
+	/*
+	 * This function clears this container.
+	 * Every single services are invalidated after calling this function.
+	 */
+	void clear() {
+		_container.clear();
+		_slots = slots_t{};
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate type as template argument.
+	 * The default predicate is kgr::all.
+	 */
+	template<typename Predicate = all, detail::enable_if_t<std::is_default_constructible<Predicate>::value, int> = 0>
+	auto fork() const -> container {
+		return _container.fork(Predicate{});
+	}
+	
+	/*
+	 * This function fork the container into a new container.
+	 * The new container must exist within the lifetime of this container.
+	 *
+	 * It takes a predicate as argument.
+	 */
+	template<typename Predicate, disable_if<std::is_base_of<memory_resource, Predicate>> = 0>
+	auto fork(Predicate predicate) const -> container {
+		return _container.fork(predicate);
+	}
+	
+	/*
+	 * This function return true if the container contains the service T. Returns false otherwise.
+	 * T nust be a single service.
+	 */
+	template<typename T, detail::enable_if_t<detail::is_service<T>::value && detail::is_single<T>::value, int> = 0>
+	bool contains() const {
+		return _container.contains<T>();
+	}
+	
+	/*
+	 * This function returns the memory resource used by this container for all its allocations.
+	 */
+	auto resource() const noexcept -> memory_resource& {
+		return _container.resource();
+	}
+
+private:
+	using slots_t = std::tuple<detail::typed_service_storage<Definitions>...>;
+	
+	///////////////////////
+	//    definition     //
+	///////////////////////
+	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function returns a service from its slot, filling it if empty.
+	 */
+	template<typename T, enable_if<is_static<T>> = 0>
+	auto definition() -> detail::injected_wrapper<T> {
+		auto& slot = std::get<slot_index<T>::value>(_slots);
+		
+		if (!slot.service) {
+			fill_slot<T>(slot);
+		}
+		
+		return wrap_slot<T>(slot);
+	}
+	
+	/*
+	 * This function returns a service definition.
+	 * This version of this function is for services without a slot, which are found in the inner container.
+	 */
+	template<typename T, typename... Args, disable_if<is_static<T>> = 0>
+	auto definition(Args&&... args) -> detail::injected_wrapper<T> {
+		auto wrapper = _container.definition<T>(std::forward<Args>(args)...);
+		
+		reset_polymorphic_slots(slots_seq{});
+		
+		return wrapper;
+	}
+	
+	/*
+	 * Constructs the service T in the inner container if needed, then saves where it is in the slot.
+	 * Constructing a service can insert overrides, so slots of polymorphic services are reset first.
+	 */
+	template<typename T>
+	void fill_slot(detail::typed_service_storage<T>& slot) {
+		_container.definition<T>();
+		
+		reset_polymorphic_slots(slots_seq{});
+		
+		slot = _container.source().storage(type_id<T>())->template cast<T>();
+	}
+	
+	template<typename T, enable_if<detail::is_polymorphic<T>> = 0>
+	static auto wrap_slot(detail::typed_service_storage<T> const& slot) noexcept -> detail::injected_wrapper<T> {
+		return detail::injected_wrapper<T>{slot};
+	}
+	
+	template<typename T, disable_if<detail::is_polymorphic<T>> = 0>
+	static auto wrap_slot(detail::typed_service_storage<T> const& slot) noexcept -> detail::injected_wrapper<T> {
+		return detail::injected_wrapper<T>{*static_cast<T*>(slot.service)};
+	}
+	
+	///////////////////////
+	//       slots       //
+	///////////////////////
+	
+	template<typename T, enable_if<is_static<T>> = 0>
+	void reset_slot() noexcept {
+		std::get<slot_index<T>::value>(_slots).service = nullptr;
+	}
+	
+	template<typename T, disable_if<is_static<T>> = 0>
+	void reset_slot() noexcept {}
+	
+	/*
+	 * Resets the slots of polymorphic services, since an inserted override changes the service they resolve to.
+	 */
+	template<std::size_t... S>
+	void reset_polymorphic_slots(detail::seq<S...>) noexcept {
+		(void) unpack{(
+			detail::is_polymorphic<Definitions>::value ? void(std::get<S>(_slots).service = nullptr) : void()
+		, 0)..., 0};
+	}
+	
+	///////////////////////
+	//      invoke       //
+	///////////////////////
+	
+	/*
+	 * This function is an helper for the public invoke function.
+	 * It unpacks arguments of the function with an integer sequence.
+	 */
+	template<typename Map, typename U, typename... Args, std::size_t... S>
+	auto invoke_helper(detail::seq<S...>, U&& function, Args&&... args)
+		-> detail::invoke_function_result_t<Map, detail::decay_t<U>, Args...>
+	{
+		return std::forward<U>(function)(
+			service<mapped_service_t<detail::invoke_function_argument_t<S, Map, detail::decay_t<U>, Args...>, Map>>()...,
+			std::forward<Args>(args)...
+		);
+	}
+	
+	container _container;
+	slots_t _slots = slots_t{};
+};
+
+} // namespace kgr
+
+#include "detail/undef.hpp"
+
+#endif // KGR_KANGARU_INCLUDE_KANGARU_STATIC_CONTAINER_HPP
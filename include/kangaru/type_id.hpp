@@ -6,11 +6,20 @@
 
 #include "kangaru/detail/config.hpp"
 
+#if defined(KGR_KANGARU_HASH_TYPE_ID) && defined(KGR_KANGARU_INDEXED_TYPE_ID)
+#error "Type ids can either be hashed or indexed, but not both"
+#endif
+
 #ifdef KGR_KANGARU_HASH_TYPE_ID
 #include "detail/string_view.hpp"
 #include "detail/hash.hpp"
 #endif
 
+#ifdef KGR_KANGARU_INDEXED_TYPE_ID
+#include <atomic>
+#include <cstddef>
+#endif
+
 #include "detail/define.hpp"
 
 namespace kgr {
@@ -120,6 +129,50 @@ inline constexpr auto type_id_impl() -> type_id_t {
 	return hash;
 }
 
+#elif defined(KGR_KANGARU_INDEXED_TYPE_ID)
+
+/**
+ * The type of a generated type id.
+ * The lower bits are a small index, and the two uppermost bits are the kind of service.
+ */
+using type_id_t = std::uint64_t;
+
+constexpr auto kind_significant_bits = std::uint64_t{2};
+
+constexpr auto index_mask = (std::uint64_t{1} << (64 - kind_significant_bits)) - 1;
+
+/**
+ * Returns the kind of service from a type id
+ */
+inline constexpr auto type_id_kind(type_id_t const id) -> service_kind_t {
+	return static_cast<service_kind_t>(id >> (64 - kind_significant_bits));
+}
+
+/**
+ * Returns the index of a type id. Indices are dense and start from one.
+ */
+inline constexpr auto type_id_index(type_id_t const id) -> std::size_t {
+	return static_cast<std::size_t>(id & index_mask);
+}
+
+/**
+ * Returns a new index each time it is called, starting from one since a null type id is never valid.
+ */
+inline auto next_type_index() noexcept -> std::uint64_t {
+	static std::atomic<std::uint64_t> counter{1};
+	return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Indices are given on first use, so they stay small and dense for the types a program actually use.
+ * They are only stable during one execution of the program.
+ */
+template<typename T>
+inline auto type_id_impl() noexcept -> type_id_t {
+	static type_id_t const id = next_type_index() | static_cast<std::uint64_t>(kind_for<T>()) << (64 - kind_significant_bits);
+	return id;
+}
+
 #else
 
 using type_id_t = void const*;
@@ -157,7 +210,7 @@ constexpr auto type_id_impl() -> type_id_t {
 	return &detail::type_id_ptr<T>::id;
 }
 
-#endif // KGR_KANGARU_HASH_TYPE_ID
+#endif // KGR_KANGARU_HASH_TYPE_ID, KGR_KANGARU_INDEXED_TYPE_ID
 
 } // namespace detail
 
@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace concurrent_container_test {
+
+static std::atomic<int> constructed_count{0};
+
+struct Dependency {
+	Dependency() {
+		constructed_count++;
+		std::this_thread::yield();
+	}
+};
+
+struct DependencyService : kgr::single_service<Dependency> {};
+
+struct Service {
+	Dependency& dependency;
+};
+
+struct ServiceDefinition : kgr::single_service<Service, kgr::dependency<DependencyService>> {};
+
+struct Base {
+	virtual ~Base() = default;
+	virtual auto value() const -> int { return 1; }
+};
+
+struct Derived : Base {
+	auto value() const -> int override { return 2; }
+};
+
+struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+struct DerivedService : kgr::single_service<Derived>, kgr::overrides<BaseService> {};
+
+struct Unique {};
+struct UniqueService : kgr::service<Unique> {};
+
+template<typename F>
+void run_threads(std::size_t amount, F function) {
+	std::vector<std::thread> threads;
+	
+	for (std::size_t i = 0 ; i < amount ; ++i) {
+		threads.emplace_back(function);
+	}
+	
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+}
+
+TEST_CASE("The concurrent container constructs singles exactly once", "[concurrent_container]") {
+	using namespace concurrent_container_test;
+	constructed_count = 0;
+	
+	kgr::concurrent_container container;
+	std::atomic<Service*> first{nullptr};
+	std::atomic<bool> same{true};
+	
+	run_threads(8, [&] {
+		for (int i = 0 ; i < 1000 ; ++i) {
+			auto const service = &container.service<ServiceDefinition>();
+			Service* expected = nullptr;
+			
+			if (!first.compare_exchange_strong(expected, service) && expected != service) {
+				same = false;
+			}
+		}
+	});
+	
+	REQUIRE(same);
+	REQUIRE(constructed_count == 1);
+	REQUIRE(container.contains<ServiceDefinition>());
+	REQUIRE(container.contains<DependencyService>());
+	REQUIRE(&first.load()->dependency == &container.service<DependencyService>());
+}
+
+TEST_CASE("The concurrent container contains services of the container it was made from", "[concurrent_container]") {
+	using namespace concurrent_container_test;
+	
+	kgr::container inner;
+	auto& dependency = inner.service<DependencyService>();
+	
+	kgr::concurrent_container container{std::move(inner)};
+	
+	REQUIRE(container.contains<DependencyService>());
+	REQUIRE(&container.service<DependencyService>() == &dependency);
+	REQUIRE_FALSE(container.emplace<DependencyService>());
+}
+
+TEST_CASE("The concurrent container publishes overrides of polymorphic services", "[concurrent_container]") {
+	using namespace concurrent_container_test;
+	
+	kgr::concurrent_container container;
+	
+	REQUIRE(container.service<BaseService>().value() == 1);
+	REQUIRE(container.emplace<DerivedService>());
+	REQUIRE(container.service<BaseService>().value() == 2);
+	REQUIRE(&container.service<BaseService>() == &container.service<DerivedService>());
+}
+
+TEST_CASE("The concurrent container constructs non single services each time", "[concurrent_container]") {
+	using namespace concurrent_container_test;
+	
+	kgr::concurrent_container container;
+	std::atomic<int> invoked{0};
+	
+	run_threads(4, [&] {
+		for (int i = 0 ; i < 100 ; ++i) {
+			container.invoke<UniqueService, DependencyService>([&](Unique, Dependency&) {
+				invoked++;
+			});
+		}
+	});
+	
+	REQUIRE(invoked == 400);
+}
+
+TEST_CASE("The concurrent container can be forked", "[concurrent_container]") {
+	using namespace concurrent_container_test;
+	
+	kgr::concurrent_container container;
+	auto& dependency = container.service<DependencyService>();
+	
+	auto fork = container.fork();
+	
+	REQUIRE(&fork.service<DependencyService>() == &dependency);
+	
+	fork.emplace<DerivedService>();
+	
+	REQUIRE_FALSE(container.contains<DerivedService>());
+	REQUIRE(container.service<BaseService>().value() == 1);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <kangaru/kangaru.hpp>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
 
 TEST_CASE("emplace add a service to the container", "[container]") {
 	struct Service {};
@@ -199,6 +202,65 @@ TEST_CASE("Container can merge", "[container]") {
 	}
 }
 
+TEST_CASE("Container can chain", "[container]") {
+	struct Service { int value = 0; };
+	struct Definition1 : kgr::single_service<Service> {};
+	struct Definition2 : kgr::single_service<Service> {};
+	struct Definition3 : kgr::single_service<Service> {};
+	
+	kgr::container c1;
+	kgr::container c2;
+	kgr::container c3;
+	
+	auto& service1 = c1.service<Definition1>();
+	auto& service2 = c2.service<Definition2>();
+	auto& conflict2 = c2.service<Definition1>();
+	auto& service3 = c3.service<Definition3>();
+	auto& conflict3 = c3.service<Definition2>();
+	
+	c1.chain(c2);
+	c1.chain(std::move(c3));
+	
+	SECTION("Chain brings all services to the target, preferring the ones found first") {
+		REQUIRE(&c1.service<Definition1>() == &service1);
+		REQUIRE(&c1.service<Definition2>() == &service2);
+		REQUIRE(&c1.service<Definition3>() == &service3);
+		REQUIRE(&service1 != &conflict2);
+		REQUIRE(&service2 != &conflict3);
+	}
+	
+	SECTION("Forks see the chained services") {
+		auto fork = c1.fork();
+		auto filtered = c1.fork<kgr::except<Definition3>>();
+		
+		REQUIRE(&fork.service<Definition2>() == &service2);
+		REQUIRE(&fork.service<Definition3>() == &service3);
+		REQUIRE(&filtered.service<Definition2>() == &service2);
+		REQUIRE(&filtered.service<Definition3>() != &service3);
+	}
+	
+	SECTION("Chained services are found the same after compact") {
+		auto fork = c1.fork<kgr::except<Definition3>>();
+		fork.compact();
+		c1.compact();
+		
+		REQUIRE(&c1.service<Definition1>() == &service1);
+		REQUIRE(&c1.service<Definition2>() == &service2);
+		REQUIRE(&c1.service<Definition3>() == &service3);
+		REQUIRE(&fork.service<Definition2>() == &service2);
+		REQUIRE_FALSE(fork.contains<Definition3>());
+	}
+	
+	SECTION("A container chained into many others is merged first") {
+		kgr::container c4;
+		c4.chain(std::move(c1));
+		
+		REQUIRE(&c4.service<Definition1>() == &service1);
+		REQUIRE(&c4.service<Definition2>() == &service2);
+		REQUIRE(&c4.service<Definition3>() == &service3);
+	}
+}
+
 TEST_CASE("the container can fork with a predicate", "[container]") {
 	struct Service {};
 	struct Definition1 : kgr::single_service<Service> {};
@@ -277,3 +339,426 @@ TEST_CASE("The predicate is never called with implementation defined services",
 		c2 = c.fork(TrapPredicate{});
 	}
 }
+
+template<std::size_t n>
+struct IndexedService {
+	std::size_t value = n;
+};
+
+template<std::size_t n>
+struct IndexedDefinition : kgr::single_service<IndexedService<n>> {};
+
+template<std::size_t... S>
+void check_many_services(kgr::detail::seq<S...>) {
+	kgr::container c;
+	
+	std::vector<void const*> first_pass{static_cast<void const*>(&c.service<IndexedDefinition<S>>())...};
+	std::vector<void const*> second_pass{static_cast<void const*>(&c.service<IndexedDefinition<S>>())...};
+	std::vector<std::size_t> values{c.service<IndexedDefinition<S>>().value...};
+	
+	REQUIRE(first_pass == second_pass);
+	REQUIRE(values == std::vector<std::size_t>{S...});
+	
+	auto fork = c.fork();
+	std::vector<void const*> fork_pass{static_cast<void const*>(&fork.service<IndexedDefinition<S>>())...};
+	
+	REQUIRE(first_pass == fork_pass);
+}
+
+TEST_CASE("The container keep services stable while it grows", "[container]") {
+	check_many_services(kgr::detail::seq_gen<100>::type{});
+}
+
+TEST_CASE("The container destroy services in order", "[container]") {
+	static std::vector<int> destroyed;
+	destroyed.clear();
+	
+	struct Service1 { ~Service1() { destroyed.push_back(1); } };
+	struct Service2 { ~Service2() { destroyed.push_back(2); } };
+	struct Service3 { ~Service3() { destroyed.push_back(3); } };
+	
+	struct Definition1 : kgr::single_service<Service1> {};
+	struct Definition2 : kgr::single_service<Service2> {};
+	struct Definition3 : kgr::single_service<Service3> {};
+	
+#ifdef KGR_KANGARU_REVERSE_DESTRUCTION
+	auto const expected = std::vector<int>{3, 2, 1};
+#else
+	auto const expected = std::vector<int>{1, 2, 3};
+#endif
+	
+	SECTION("When the container is destroyed") {
+		{
+			kgr::container c;
+			c.service<Definition1>();
+			c.service<Definition2>();
+			c.service<Definition3>();
+			
+			REQUIRE(destroyed.empty());
+		}
+		
+		REQUIRE(destroyed == expected);
+	}
+	
+	SECTION("When the container is cleared") {
+		kgr::container c;
+		c.service<Definition1>();
+		c.service<Definition2>();
+		c.service<Definition3>();
+		
+		c.clear();
+		
+		REQUIRE(destroyed == expected);
+		REQUIRE_FALSE(c.contains<Definition1>());
+	}
+}
+
+TEST_CASE("The container can hold large and overaligned services", "[container]") {
+	struct alignas(64) Aligned { char data[3]; };
+	struct Large { char data[100000]; };
+	
+	struct AlignedDefinition : kgr::single_service<Aligned> {};
+	struct LargeDefinition : kgr::single_service<Large> {};
+	
+	kgr::container c;
+	
+	c.service<IndexedDefinition<0>>();
+	auto& aligned = c.service<AlignedDefinition>();
+	auto& large = c.service<LargeDefinition>();
+	c.service<IndexedDefinition<1>>();
+	
+	REQUIRE(reinterpret_cast<std::uintptr_t>(&aligned) % 64 == 0);
+	REQUIRE(&large == &c.service<LargeDefinition>());
+	REQUIRE(c.service<IndexedDefinition<1>>().value == 1);
+}
+
+struct CountingResource : kgr::memory_resource {
+	std::size_t allocated = 0;
+	std::size_t allocations = 0;
+
+private:
+	auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+		allocated += bytes;
+		allocations++;
+		return kgr::new_delete_resource().allocate(bytes, alignment);
+	}
+	
+	void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override {
+		allocated -= bytes;
+		kgr::new_delete_resource().deallocate(memory, bytes, alignment);
+	}
+};
+
+TEST_CASE("The container allocates from its memory resource", "[container]") {
+	struct Service { int value = 42; };
+	struct Definition1 : kgr::single_service<Service> {};
+	struct Definition2 : kgr::single_service<Service> {};
+	struct DefinitionPoly : kgr::single_service<Service>, kgr::polymorphic {};
+	struct DefinitionOver : kgr::single_service<Service>, kgr::overrides<DefinitionPoly> {};
+	
+	CountingResource resource;
+	
+	SECTION("All allocations are given back") {
+		{
+			kgr::container c{resource};
+			
+			REQUIRE(&c.resource() == &resource);
+			
+			c.service<Definition1>();
+			c.service<DefinitionOver>();
+			
+			REQUIRE(resource.allocations > 0);
+			REQUIRE(resource.allocated > 0);
+		}
+		
+		REQUIRE(resource.allocated == 0);
+	}
+	
+	SECTION("A fork uses the resource of the original container by default") {
+		kgr::container c{resource};
+		c.service<Definition1>();
+		
+		auto fork = c.fork();
+		
+		REQUIRE(&fork.resource() == &resource);
+	}
+	
+	SECTION("A fork can use another resource") {
+		kgr::container c;
+		c.service<Definition1>();
+		c.service<DefinitionOver>();
+		
+		{
+			auto fork = c.fork<kgr::except<Definition2>>(resource);
+			
+			REQUIRE(&fork.resource() == &resource);
+			REQUIRE(&fork.service<Definition1>() == &c.service<Definition1>());
+			REQUIRE(fork.service<DefinitionPoly>().value == 42);
+			
+			fork.service<Definition2>();
+			
+			REQUIRE(resource.allocated > 0);
+			REQUIRE_FALSE(c.contains<Definition2>());
+		}
+		
+		REQUIRE(resource.allocated == 0);
+	}
+	
+	SECTION("A fork can use a monotonic buffer") {
+		kgr::container c;
+		c.service<Definition1>();
+		
+		alignas(std::max_align_t) unsigned char buffer[512];
+		kgr::monotonic_buffer_resource monotonic{buffer, sizeof(buffer), resource};
+		
+		{
+			auto fork = c.fork(kgr::all{}, monotonic);
+			fork.service<Definition2>();
+			fork.service<DefinitionOver>();
+			
+			REQUIRE(fork.service<Definition1>().value == 42);
+		}
+		
+		monotonic.release();
+		
+		REQUIRE(resource.allocated == 0);
+	}
+	
+	SECTION("Services of a container with another resource can be merged") {
+		kgr::container c;
+		
+		{
+			kgr::container other{resource};
+			other.service<Definition1>();
+			
+			c.merge(std::move(other));
+		}
+		
+		REQUIRE(c.contains<Definition1>());
+		REQUIRE(c.service<Definition1>().value == 42);
+		
+		c.clear();
+		
+		REQUIRE(resource.allocated == 0);
+	}
+}
+
+template<std::size_t... S>
+static auto indexed_ids(kgr::detail::seq<S...>) -> std::vector<kgr::type_id_t> {
+	return std::vector<kgr::type_id_t>{kgr::type_id<IndexedDefinition<S>>()...};
+}
+
+TEST_CASE("The table of services keeps a few services inline", "[container]") {
+	using table_t = kgr::detail::service_table;
+	
+	CountingResource resource;
+	std::size_t const small_capacity = table_t::small_capacity;
+	auto const ids = indexed_ids(kgr::detail::seq_gen<table_t::small_capacity + 1>::type{});
+	auto const last = ids.back();
+	
+	table_t table{resource};
+	
+	for (auto const id : ids) {
+		if (id != last) {
+			REQUIRE(table.emplace(id, kgr::detail::service_storage{kgr::detail::override_index, static_cast<void*>(&resource)}).second);
+		}
+	}
+	
+	REQUIRE(table.size() == small_capacity);
+	REQUIRE(resource.allocations == 0);
+	REQUIRE_FALSE(table.contains(last));
+	
+	SECTION("Moving and copying keep the services") {
+		table_t moved{std::move(table)};
+		table_t copy{moved};
+		
+		REQUIRE(table.empty());
+		REQUIRE(moved.size() == small_capacity);
+		REQUIRE(copy.size() == small_capacity);
+		REQUIRE(resource.allocations == 0);
+		
+		for (auto const id : ids) {
+			REQUIRE(moved.contains(id) == (id != last));
+			REQUIRE(copy.contains(id) == (id != last));
+		}
+	}
+	
+	SECTION("One more service moves them to allocated slots") {
+		REQUIRE(table.emplace(last, kgr::detail::service_storage{}).second);
+		REQUIRE(resource.allocations == 1);
+		REQUIRE(table.size() == small_capacity + 1);
+		
+		for (auto const id : ids) {
+			REQUIRE(table.contains(id));
+		}
+		
+		table.clear();
+		
+		REQUIRE(resource.allocated == 0);
+		REQUIRE_FALSE(table.contains(last));
+	}
+}
+
+TEST_CASE("Keys are found at any position of a packed array", "[container]") {
+	auto const ids = indexed_ids(kgr::detail::seq_gen<24>::type{});
+	kgr::type_id_t keys[24] = {};
+	
+	std::copy(ids.begin(), ids.end(), keys);
+	
+	for (std::size_t size = 0 ; size <= ids.size() ; ++size) {
+		for (std::size_t nth = 0 ; nth < ids.size() ; ++nth) {
+			REQUIRE(kgr::detail::find_key(keys, size, ids[nth]) == (nth < size ? nth : size));
+		}
+	}
+	
+	SECTION("The first equal key is found") {
+		std::fill(keys + 3, keys + 24, ids[3]);
+		
+		REQUIRE(kgr::detail::find_key(keys, 24, ids[3]) == 3);
+		REQUIRE(kgr::detail::find_key(keys, 3, ids[3]) == 3);
+	}
+}
+
+TEST_CASE("Forks share the services of the original container", "[container]") {
+	struct Service { int value = 0; };
+	struct Definition1 : kgr::single_service<Service> {};
+	struct Definition2 : kgr::single_service<Service> {};
+	struct Definition3 : kgr::single_service<Service> {};
+	
+	kgr::container c;
+	c.service<Definition1>().value = 1;
+	
+	SECTION("A fork of a fork apply every predicates") {
+		c.service<Definition2>();
+		c.service<Definition3>();
+		
+		auto fork1 = c.fork<kgr::except<Definition1>>();
+		auto fork2 = fork1.fork<kgr::except<Definition2>>();
+		
+		REQUIRE_FALSE(fork2.contains<Definition1>());
+		REQUIRE_FALSE(fork2.contains<Definition2>());
+		REQUIRE(fork2.contains<Definition3>());
+		REQUIRE(&fork2.service<Definition3>() == &c.service<Definition3>());
+	}
+	
+	SECTION("Clearing a fork leaves the original untouched") {
+		auto fork = c.fork();
+		fork.clear();
+		
+		REQUIRE_FALSE(fork.contains<Definition1>());
+		REQUIRE(c.contains<Definition1>());
+		REQUIRE(c.service<Definition1>().value == 1);
+	}
+	
+	SECTION("Replacing a service in a fork leaves the original untouched") {
+		auto fork = c.fork();
+		fork.replace<Definition1>();
+		
+		REQUIRE(fork.service<Definition1>().value == 0);
+		REQUIRE(c.service<Definition1>().value == 1);
+	}
+	
+	SECTION("Each fork observe the services as they were when forked") {
+		std::vector<kgr::container> forks;
+		
+		for (int i = 0 ; i < 20 ; ++i) {
+			forks.push_back(c.fork());
+			c.replace<Definition1>();
+			c.service<Definition1>().value = i + 2;
+		}
+		
+		for (int i = 0 ; i < 20 ; ++i) {
+			REQUIRE(forks[i].service<Definition1>().value == i + 1);
+		}
+		
+		REQUIRE(c.service<Definition1>().value == 21);
+	}
+}
+
+TEST_CASE("Services found again are the current ones", "[container]") {
+	struct Service {
+		int value = 0;
+	};
+	
+	struct Definition : kgr::single_service<Service> {};
+	
+	struct Base {
+		virtual ~Base() = default;
+		virtual auto value() const -> int { return 1; }
+	};
+	
+	struct Derived : Base {
+		auto value() const -> int override { return 2; }
+	};
+	
+	struct BaseDefinition : kgr::single_service<Base>, kgr::polymorphic {};
+	struct DerivedDefinition : kgr::single_service<Derived>, kgr::overrides<BaseDefinition> {};
+	
+	kgr::container c;
+	c.service<Definition>().value = 1;
+	REQUIRE(c.service<BaseDefinition>().value() == 1);
+	
+	SECTION("After replace") {
+		c.replace<Definition>();
+		REQUIRE(c.service<Definition>().value == 0);
+	}
+	
+	SECTION("After clear") {
+		c.clear();
+		REQUIRE(c.service<Definition>().value == 0);
+	}
+	
+	SECTION("After an override is added") {
+		c.emplace<DerivedDefinition>();
+		REQUIRE(c.service<BaseDefinition>().value() == 2);
+	}
+	
+	SECTION("After merge and rebase") {
+		kgr::container other;
+		other.service<Definition>().value = 2;
+		other.emplace<DerivedDefinition>();
+		
+		auto fork = c.fork();
+		REQUIRE(fork.service<Definition>().value == 1);
+		
+		fork.rebase(other);
+		fork.merge(std::move(other));
+		
+		REQUIRE(fork.service<Definition>().value == 1);
+		REQUIRE(fork.service<BaseDefinition>().value() == 1);
+		REQUIRE(fork.contains<DerivedDefinition>());
+	}
+}
+
+TEST_CASE("Many services can be constructed at once", "[container]") {
+	struct Service1 {};
+	struct Service2 {};
+	
+	struct Service3 {
+		Service1& service1;
+	};
+	
+	struct Definition1 : kgr::single_service<Service1> {};
+	struct Definition2 : kgr::single_service<Service2> {};
+	struct Definition3 : kgr::single_service<Service3, kgr::dependency<Definition1>> {};
+	struct Definition4 : kgr::service<Service2> {};
+	
+	kgr::container c;
+	
+	SECTION("emplace_all only constructs services not found") {
+		REQUIRE(c.emplace<Definition1>());
+		
+		REQUIRE(c.emplace_all<Definition1, Definition2, Definition3>() == 2);
+		REQUIRE(c.contains<Definition2>());
+		REQUIRE(&c.service<Definition3>().service1 == &c.service<Definition1>());
+		REQUIRE(c.emplace_all<Definition1, Definition2>() == 0);
+	}
+	
+	SECTION("service_all returns the services in order") {
+		auto services = c.service_all<Definition3, Definition2, Definition4>();
+		
+		REQUIRE(&std::get<0>(services) == &c.service<Definition3>());
+		REQUIRE(&std::get<1>(services) == &c.service<Definition2>());
+		REQUIRE(&std::get<0>(services).service1 == &c.service<Definition1>());
+	}
+}
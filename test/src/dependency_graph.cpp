@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+
+// Services of the cars example
+namespace dependency_graph_cars {
+
+struct Fuel {
+protected:
+	Fuel() = default;
+};
+
+struct Car {
+protected:
+	explicit Car(Fuel*) {}
+};
+
+struct Petrol : Fuel {};
+struct PremiumPetrol : Petrol {};
+struct Diesel : Fuel {};
+
+struct OpelAstra : Car {
+	explicit OpelAstra(Fuel& fuel) : Car{&fuel} {}
+};
+
+struct NissanQuashqai : Car {
+	explicit NissanQuashqai(Fuel& fuel) : Car{&fuel} {}
+};
+
+struct HondaHRV : Car {
+	explicit HondaHRV(Fuel& fuel) : Car{&fuel} {}
+};
+
+struct HondaHRVDiesel : HondaHRV {
+	explicit HondaHRVDiesel(Fuel& fuel) : HondaHRV{fuel} {}
+};
+
+struct FuelService           : kgr::abstract_service<Fuel> {};
+struct PetrolService         : kgr::single_service<Petrol>, kgr::overrides<FuelService> {};
+struct PremiumPetrolService  : kgr::single_service<PremiumPetrol> {};
+struct DieselService         : kgr::single_service<Diesel> {};
+
+struct OpelAstraService      : kgr::service<OpelAstra, kgr::dependency<PetrolService>> {};
+struct NissanQuashqaiService : kgr::service<NissanQuashqai, kgr::dependency<PetrolService>> {};
+struct HondaHRVService       : kgr::service<HondaHRV, kgr::dependency<PremiumPetrolService>> {};
+struct HondaHRVDieselService : kgr::service<HondaHRVDiesel, kgr::dependency<DieselService>> {};
+
+using graph = kgr::dependency_graph<OpelAstraService, NissanQuashqaiService, HondaHRVService, HondaHRVDieselService>;
+
+static_assert(std::is_same<graph::services, kgr::detail::meta_list<
+	PetrolService, OpelAstraService, NissanQuashqaiService, PremiumPetrolService, HondaHRVService, DieselService, HondaHRVDieselService
+>>::value, "The services must be in topological order");
+
+static_assert(graph::size() == 7, "Every service must be a node");
+static_assert(!graph::contains<FuelService>(), "Overriden services are not dependencies");
+static_assert(graph::dependency_count(graph::index<OpelAstraService>()) == 1, "");
+static_assert(graph::dependency(graph::index<OpelAstraService>(), 0) == graph::index<PetrolService>(), "");
+static_assert(graph::depth(graph::index<HondaHRVDieselService>()) == 1, "");
+static_assert(graph::max_depth() == 1, "");
+
+}
+
+namespace dependency_graph_test {
+
+struct Leaf {};
+struct Middle { Leaf& leaf; };
+struct Other { Leaf& leaf; };
+struct Top { Middle middle; Other& other; };
+
+struct LeafService : kgr::single_service<Leaf> {};
+struct MiddleService : kgr::service<Middle, kgr::dependency<LeafService>> {};
+struct OtherService : kgr::single_service<Other, kgr::dependency<LeafService>> {};
+struct TopService : kgr::single_service<Top, kgr::dependency<MiddleService, OtherService>> {};
+
+struct Configured {
+	void configure(Top&) {}
+};
+
+struct ConfiguredService : kgr::single_service<Configured>, kgr::autocall<
+	kgr::invoke<kgr::method<decltype(&Configured::configure), &Configured::configure>, TopService>
+> {};
+
+}
+
+TEST_CASE("The dependency graph lists services after their dependencies", "[dependency_graph]") {
+	using namespace dependency_graph_cars;
+	
+	REQUIRE(graph::size() == 7);
+	
+	for (std::size_t node = 0 ; node < graph::size() ; ++node) {
+		for (std::size_t nth = 0 ; nth < graph::dependency_count(node) ; ++nth) {
+			REQUIRE(graph::dependency(node, nth) < node);
+		}
+	}
+	
+	REQUIRE(graph::dependency_count(graph::index<PetrolService>()) == 0);
+	REQUIRE(graph::dependency_count(graph::index<NissanQuashqaiService>()) == 1);
+	REQUIRE(graph::dependency(graph::index<NissanQuashqaiService>(), 0) == graph::index<PetrolService>());
+	REQUIRE(graph::dependency(graph::index<HondaHRVService>(), 0) == graph::index<PremiumPetrolService>());
+	REQUIRE(graph::dependency(graph::index<HondaHRVDieselService>(), 0) == graph::index<DieselService>());
+}
+
+TEST_CASE("The dependency graph computes the depth of each service", "[dependency_graph]") {
+	using namespace dependency_graph_test;
+	using graph = kgr::dependency_graph<ConfiguredService>;
+	
+	static_assert(std::is_same<graph::services, kgr::detail::meta_list<
+		LeafService, MiddleService, OtherService, TopService, ConfiguredService
+	>>::value, "The services must be in topological order");
+	
+	REQUIRE(graph::depth(graph::index<LeafService>()) == 0);
+	REQUIRE(graph::depth(graph::index<MiddleService>()) == 1);
+	REQUIRE(graph::depth(graph::index<OtherService>()) == 1);
+	REQUIRE(graph::depth(graph::index<TopService>()) == 2);
+	REQUIRE(graph::depth(graph::index<ConfiguredService>()) == 3);
+	REQUIRE(graph::max_depth() == 3);
+	
+	REQUIRE(graph::dependency_count(graph::index<TopService>()) == 2);
+	REQUIRE(graph::dependency(graph::index<TopService>(), 0) == graph::index<MiddleService>());
+	REQUIRE(graph::dependency(graph::index<TopService>(), 1) == graph::index<OtherService>());
+	REQUIRE(graph::dependency(graph::index<ConfiguredService>(), 0) == graph::index<TopService>());
+}
+
+TEST_CASE("The dependency graph of no services is empty", "[dependency_graph]") {
+	using graph = kgr::dependency_graph<>;
+	
+	REQUIRE(graph::size() == 0);
+	REQUIRE(graph::max_depth() == 0);
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace frozen_container_test {
+
+static int constructed_count = 0;
+
+struct Dependency {
+	Dependency() {
+		constructed_count++;
+	}
+};
+
+struct DependencyService : kgr::single_service<Dependency> {};
+
+struct Service {
+	Dependency& dependency;
+};
+
+struct ServiceDefinition : kgr::single_service<Service, kgr::dependency<DependencyService>> {};
+
+struct Unfrozen {
+	Dependency& dependency;
+};
+
+struct UnfrozenService : kgr::single_service<Unfrozen, kgr::dependency<DependencyService>> {};
+
+struct Value {
+	Dependency& dependency;
+};
+
+struct ValueService : kgr::service<Value, kgr::dependency<DependencyService>> {};
+
+struct Base {
+	virtual ~Base() = default;
+	virtual auto value() const -> int { return 1; }
+};
+
+struct Derived : Base {
+	auto value() const -> int override { return 2; }
+};
+
+struct Other : Base {
+	auto value() const -> int override { return 3; }
+};
+
+struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+struct DerivedService : kgr::single_service<Derived>, kgr::overrides<BaseService> {};
+struct OtherService : kgr::single_service<Other>, kgr::overrides<BaseService> {};
+
+auto service_map(Dependency const&) -> DependencyService;
+
+static char const ids[1000] = {};
+
+// Distinct ids that are not the id of any type, whether ids are pointers or hashes
+template<typename Id = kgr::type_id_t, kgr::detail::enable_if_t<std::is_pointer<Id>::value, int> = 0>
+auto fake_id(std::size_t const i) -> Id {
+	return ids + i;
+}
+
+template<typename Id = kgr::type_id_t, kgr::detail::enable_if_t<!std::is_pointer<Id>::value, int> = 0>
+auto fake_id(std::size_t const i) -> Id {
+	return (i + 1) * std::uint64_t{0x9E3779B97F4A7C15};
+}
+
+}
+
+TEST_CASE("The frozen container returns the singles of the container", "[frozen_container]") {
+	using namespace frozen_container_test;
+	constructed_count = 0;
+	
+	kgr::container container;
+	auto& service = container.service<ServiceDefinition>();
+	
+	auto frozen = container.freeze();
+	
+	REQUIRE(frozen.contains<ServiceDefinition>());
+	REQUIRE(frozen.contains<DependencyService>());
+	REQUIRE_FALSE(frozen.contains<UnfrozenService>());
+	REQUIRE(&frozen.service<ServiceDefinition>() == &service);
+	REQUIRE(&frozen.service<DependencyService>() == &service.dependency);
+	REQUIRE(constructed_count == 1);
+	
+	SECTION("New singles are constructed in the child") {
+		auto& unfrozen = frozen.service<UnfrozenService>();
+		
+		REQUIRE(&unfrozen == &frozen.service<UnfrozenService>());
+		REQUIRE(&unfrozen.dependency == &service.dependency);
+		REQUIRE(frozen.contains<UnfrozenService>());
+		REQUIRE_FALSE(container.contains<UnfrozenService>());
+		REQUIRE(constructed_count == 1);
+	}
+	
+	SECTION("Services that are not single use the frozen singles") {
+		REQUIRE(&frozen.service<ValueService>().dependency == &service.dependency);
+		
+		frozen.invoke([&](Dependency& dependency) {
+			REQUIRE(&dependency == &service.dependency);
+		});
+	}
+	
+	SECTION("Forks see the frozen services and the child") {
+		auto& unfrozen = frozen.service<UnfrozenService>();
+		auto fork = frozen.fork();
+		
+		REQUIRE(&fork.service<ServiceDefinition>() == &service);
+		REQUIRE(&fork.service<UnfrozenService>() == &unfrozen);
+	}
+}
+
+TEST_CASE("The frozen container sees overrides inserted by its child", "[frozen_container]") {
+	using namespace frozen_container_test;
+	
+	kgr::container container;
+	container.emplace<DerivedService>();
+	
+	auto frozen = container.freeze();
+	
+	REQUIRE(frozen.service<BaseService>().value() == 2);
+	
+	frozen.service<OtherService>();
+	
+	REQUIRE(frozen.service<BaseService>().value() == 3);
+	REQUIRE(container.service<BaseService>().value() == 2);
+	
+	auto overrides = frozen.service<kgr::override_range_service<BaseService>>();
+	REQUIRE(std::distance(overrides.begin(), overrides.end()) == 2);
+}
+
+TEST_CASE("The frozen table finds every id with a single probe", "[frozen_container]") {
+	using namespace frozen_container_test;
+	
+	kgr::detail::service_table services;
+	std::vector<int> values(500);
+	
+	for (std::size_t i = 0 ; i < values.size() ; ++i) {
+		services.emplace(fake_id(i), kgr::detail::service_storage{kgr::detail::override_index, static_cast<void*>(&values[i])});
+	}
+	
+	kgr::detail::frozen_service_table const table{services};
+	
+	REQUIRE(table.size() == values.size());
+	
+	for (std::size_t i = 0 ; i < values.size() ; ++i) {
+		auto const found = table.find(fake_id(i));
+		
+		REQUIRE(found);
+		REQUIRE(&found->service<int>() == &values[i]);
+	}
+	
+	for (std::size_t i = values.size() ; i < 1000 ; ++i) {
+		REQUIRE_FALSE(table.find(fake_id(i)));
+	}
+	
+	REQUIRE_FALSE(kgr::detail::frozen_service_table{}.find(fake_id(0)));
+}
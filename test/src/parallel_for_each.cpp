@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace parallel_for_each_test {
+
+struct Handler {
+	virtual ~Handler() = default;
+	virtual void handle() = 0;
+	
+	int calls = 0;
+};
+
+template<int n>
+struct Implementation : Handler {
+	void handle() override {
+		calls++;
+	}
+};
+
+struct Failing : Handler {
+	void handle() override {
+		throw std::runtime_error{"cannot handle"};
+	}
+};
+
+struct HandlerService : kgr::abstract_service<Handler> {};
+
+template<int n>
+struct ImplementationService : kgr::single_service<Implementation<n>>, kgr::overrides<HandlerService> {};
+
+struct FailingService : kgr::single_service<Failing>, kgr::overrides<HandlerService> {};
+
+/*
+ * Runs each task on its own thread, joined when the executor is destroyed.
+ */
+struct thread_executor {
+	~thread_executor() {
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+	
+	template<typename Task>
+	void operator()(Task task) {
+		threads.emplace_back(task);
+	}
+	
+	std::vector<std::thread> threads;
+};
+
+void emplace_handlers(kgr::container& container) {
+	container.emplace<ImplementationService<0>>();
+	container.emplace<ImplementationService<1>>();
+	container.emplace<ImplementationService<2>>();
+	container.emplace<ImplementationService<3>>();
+	container.emplace<ImplementationService<4>>();
+}
+
+}
+
+TEST_CASE("Parallel for each calls the function once with every override", "[parallel_for_each]") {
+	using namespace parallel_for_each_test;
+	
+	kgr::container container;
+	emplace_handlers(container);
+	
+	std::mutex mutex;
+	std::set<Handler*> handlers;
+	
+	auto const chunk_size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{2}, std::size_t{5}, std::size_t{8});
+	
+	{
+		thread_executor executor;
+		
+		kgr::parallel_for_each<HandlerService>(container, [&](Handler& handler) {
+			handler.handle();
+			
+			std::lock_guard<std::mutex> lock{mutex};
+			handlers.insert(&handler);
+		}, executor, chunk_size);
+		
+		REQUIRE(executor.threads.size() <= (chunk_size > 1 ? (5 + chunk_size - 1) / chunk_size - 1 : 4));
+	}
+	
+	REQUIRE(handlers.size() == 5);
+	REQUIRE(handlers.count(&container.service<ImplementationService<0>>()) == 1);
+	REQUIRE(handlers.count(&container.service<ImplementationService<4>>()) == 1);
+	
+	for (auto const handler : handlers) {
+		REQUIRE(handler->calls == 1);
+	}
+}
+
+TEST_CASE("Parallel for each does nothing without overrides", "[parallel_for_each]") {
+	using namespace parallel_for_each_test;
+	
+	kgr::container container;
+	int calls = 0;
+	
+	kgr::parallel_for_each<HandlerService>(container, [&](Handler&) { ++calls; }, [](std::function<void()> task) { task(); });
+	
+	REQUIRE(calls == 0);
+}
+
+TEST_CASE("Parallel for each processes the chunks of tasks that are not run", "[parallel_for_each]") {
+	using namespace parallel_for_each_test;
+	
+	kgr::container container;
+	emplace_handlers(container);
+	
+	std::vector<std::function<void()>> late;
+	
+	kgr::parallel_for_each<HandlerService>(container, [](Handler& handler) { handler.handle(); }, [&](std::function<void()> task) {
+		late.push_back(std::move(task));
+	});
+	
+	REQUIRE(container.service<ImplementationService<0>>().calls == 1);
+	REQUIRE(container.service<ImplementationService<4>>().calls == 1);
+	REQUIRE_FALSE(late.empty());
+	
+	for (auto& task : late) {
+		task();
+	}
+	
+	REQUIRE(container.service<ImplementationService<2>>().calls == 1);
+}
+
+TEST_CASE("Parallel for each rethrows the exception of the function", "[parallel_for_each]") {
+	using namespace parallel_for_each_test;
+	
+	kgr::container container;
+	emplace_handlers(container);
+	container.emplace<FailingService>();
+	
+	thread_executor executor;
+	
+	REQUIRE_THROWS_AS(kgr::parallel_for_each<HandlerService>(container, [](Handler& handler) { handler.handle(); }, executor), std::runtime_error);
+}
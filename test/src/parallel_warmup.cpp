@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace parallel_warmup_test {
+
+static std::atomic<int> constructed_count{0};
+
+struct Root {
+	Root() {
+		constructed_count++;
+		std::this_thread::yield();
+	}
+};
+
+struct Left {
+	Root& root;
+};
+
+struct Right {
+	Root& root;
+};
+
+struct Top {
+	Left& left;
+	Right& right;
+};
+
+struct RootService : kgr::single_service<Root> {};
+struct LeftService : kgr::single_service<Left, kgr::dependency<RootService>> {};
+struct RightService : kgr::single_service<Right, kgr::dependency<RootService>> {};
+struct TopService : kgr::single_service<Top, kgr::dependency<LeftService, RightService>> {};
+
+struct Configured {
+	void configure(Left& l, Right& r) {
+		left = &l;
+		right = &r;
+	}
+	
+	Left* left = nullptr;
+	Right* right = nullptr;
+};
+
+struct ConfiguredService : kgr::single_service<Configured>, kgr::autocall<
+	kgr::invoke<kgr::method<decltype(&Configured::configure), &Configured::configure>, LeftService, RightService>
+> {};
+
+struct Base {
+	virtual ~Base() = default;
+	virtual auto value() const -> int { return 1; }
+};
+
+struct Derived : Base {
+	auto value() const -> int override { return 2; }
+};
+
+struct User {
+	Base& base;
+};
+
+struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+struct DerivedService : kgr::single_service<Derived>, kgr::overrides<BaseService> {};
+struct UserService : kgr::single_service<User, kgr::dependency<BaseService>> {};
+
+struct Throwing {
+	Throwing() {
+		throw std::runtime_error{"cannot construct"};
+	}
+};
+
+struct ThrowingService : kgr::single_service<Throwing> {};
+
+struct Dependent {
+	Throwing& throwing;
+};
+
+struct DependentService : kgr::single_service<Dependent, kgr::dependency<ThrowingService>> {};
+
+struct Wired {
+	Left& left;
+};
+
+auto service_map(Left const&) -> LeftService;
+auto service_map(Wired const&) -> kgr::autowire_single;
+
+/*
+ * Runs each task on its own thread, joined when the executor is destroyed.
+ */
+struct thread_executor {
+	~thread_executor() {
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+	
+	template<typename Task>
+	void operator()(Task task) {
+		std::lock_guard<std::mutex> lock{mutex};
+		threads.emplace_back(task);
+	}
+	
+	std::mutex mutex;
+	std::vector<std::thread> threads;
+};
+
+}
+
+TEST_CASE("Parallel warmup constructs shared dependencies exactly once", "[parallel_warmup]") {
+	using namespace parallel_warmup_test;
+	constructed_count = 0;
+	
+	kgr::container container;
+	
+	{
+		thread_executor executor;
+		container.parallel_warmup<TopService>(executor);
+	}
+	
+	REQUIRE(constructed_count == 1);
+	REQUIRE(container.contains<RootService>());
+	REQUIRE(container.contains<LeftService>());
+	REQUIRE(container.contains<RightService>());
+	REQUIRE(container.contains<TopService>());
+	
+	auto& top = container.service<TopService>();
+	REQUIRE(&top.left == &container.service<LeftService>());
+	REQUIRE(&top.right == &container.service<RightService>());
+	REQUIRE(&top.left.root == &container.service<RootService>());
+	REQUIRE(&top.right.root == &container.service<RootService>());
+	REQUIRE(constructed_count == 1);
+}
+
+TEST_CASE("Parallel warmup runs autocall with the dependencies of the container", "[parallel_warmup]") {
+	using namespace parallel_warmup_test;
+	
+	kgr::container container;
+	auto& root = container.service<RootService>();
+	
+	container.parallel_warmup<ConfiguredService>([](std::function<void()> task) { task(); });
+	
+	auto& configured = container.service<ConfiguredService>();
+	REQUIRE(configured.left == &container.service<LeftService>());
+	REQUIRE(configured.right == &container.service<RightService>());
+	REQUIRE(&configured.left->root == &root);
+}
+
+TEST_CASE("Parallel warmup constructs overrides before the services using their parent", "[parallel_warmup]") {
+	using namespace parallel_warmup_test;
+	
+	kgr::container container;
+	
+	{
+		thread_executor executor;
+		container.parallel_warmup<UserService, DerivedService>(executor);
+	}
+	
+	REQUIRE(container.service<UserService>().base.value() == 2);
+	REQUIRE(container.service<BaseService>().value() == 2);
+	
+	auto overrides = container.service<kgr::override_range_service<BaseService>>();
+	REQUIRE(std::distance(overrides.begin(), overrides.end()) == 1);
+}
+
+TEST_CASE("Parallel warmup rethrows the exception of a service", "[parallel_warmup]") {
+	using namespace parallel_warmup_test;
+	
+	kgr::container container;
+	
+	{
+		thread_executor executor;
+		REQUIRE_THROWS_AS((container.parallel_warmup<DependentService, RootService>(executor)), std::runtime_error);
+	}
+	
+	REQUIRE_FALSE(container.contains<ThrowingService>());
+	REQUIRE_FALSE(container.contains<DependentService>());
+}
+
+TEST_CASE("Parallel warmup constructs services injecting the container on the calling thread", "[parallel_warmup]") {
+	using namespace parallel_warmup_test;
+	
+	kgr::container container;
+	
+	{
+		thread_executor executor;
+		container.parallel_warmup<kgr::mapped_service_t<Wired>, RightService>(executor);
+	}
+	
+	REQUIRE(container.contains<kgr::mapped_service_t<Wired>>());
+	REQUIRE(container.contains<RightService>());
+	REQUIRE(&container.service<kgr::mapped_service_t<Wired>>().left == &container.service<LeftService>());
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <initializer_list>
+#include <memory>
 
 namespace service_range_test {
 
@@ -53,6 +54,23 @@ struct AbstractService : kgr::abstract_service<Base> {};
 struct Concrete1Service : kgr::single_service<Base>, kgr::overrides<AbstractService> {};
 struct Concrete2Service : kgr::single_service<Base>, kgr::overrides<AbstractService> {};
 
+struct Shape {
+	virtual ~Shape() = default;
+	virtual auto sides() const -> int = 0;
+};
+
+struct Triangle : Shape {
+	auto sides() const -> int override { return 3; }
+};
+
+struct Square : Shape {
+	auto sides() const -> int override { return 4; }
+};
+
+struct ShapeService : kgr::abstract_shared_service<Shape> {};
+struct TriangleService : kgr::shared_service<Triangle>, kgr::overrides<ShapeService> {};
+struct SquareService : kgr::shared_service<Square>, kgr::overrides<ShapeService> {};
+
 }
 
 TEST_CASE("The container holds a list of overriders", "[service_range, virtual]") {
@@ -149,3 +167,111 @@ TEST_CASE("The container holds a list of overriders", "[service_range, virtual]"
 		CHECK(std::distance(range.begin(), range.end()) == 2);
 	}
 }
+
+TEST_CASE("The list of overriders is kept by merge and rebase", "[service_range, virtual]") {
+	using namespace service_range_test;
+	kgr::container container;
+	kgr::container other;
+	
+	container.emplace<Concrete1Service>(Type::Derived1T);
+	other.emplace<BaseService>();
+	other.emplace<Derived2Service>();
+	
+	SECTION("merge") {
+		container.merge(std::move(other));
+	}
+	
+	SECTION("chain") {
+		container.chain(std::move(other));
+	}
+	
+	SECTION("chain and compact") {
+		container.chain(std::move(other));
+		container.compact();
+	}
+	
+	SECTION("chain a fork") {
+		auto fork = other.fork(kgr::except<Derived1Service>{});
+		container.chain(fork);
+	}
+	
+	SECTION("rebase") {
+		container.rebase(other);
+	}
+	
+	SECTION("rebase a fork") {
+		auto fork = other.fork(kgr::except<Derived1Service>{});
+		container.rebase(fork);
+	}
+	
+	auto const range = container.service<kgr::override_range_service<BaseService>>();
+	auto const abstract_range = container.service<kgr::override_range_service<AbstractService>>();
+	
+	test_iterator_values(
+		range.begin(), range.end(),
+		{Type::BaseT, Type::Derived2T}
+	);
+	
+	test_iterator_values(
+		abstract_range.begin(), abstract_range.end(),
+		{Type::Derived1T}
+	);
+	
+	CHECK(std::distance(range.begin(), range.end()) == 2);
+	CHECK(std::distance(abstract_range.begin(), abstract_range.end()) == 1);
+}
+
+TEST_CASE("The override view can be indexed and iterated many times", "[service_range, virtual]") {
+	using namespace service_range_test;
+	kgr::container container;
+	
+	container.emplace<BaseService>();
+	container.emplace<Derived1Service>();
+	container.emplace<Derived2Service>();
+	
+	auto view = container.service<kgr::override_view_service<BaseService>>();
+	
+	REQUIRE(view.size() == 3);
+	REQUIRE_FALSE(view.empty());
+	CHECK(view[0].type == Type::BaseT);
+	CHECK(&view[1] == &container.service<Derived1Service>());
+	CHECK(view[2].type == Type::Derived2T);
+	CHECK(std::distance(view.begin(), view.end()) == 3);
+	
+	test_iterator_values(
+		view.begin(), view.end(),
+		{Type::BaseT, Type::Derived1T, Type::Derived2T}
+	);
+	
+	int count = 0;
+	std::for_each(view.begin(), view.end(), [&](Base&) { ++count; });
+	std::for_each(view.begin(), view.end(), [&](Base&) { ++count; });
+	CHECK(count == 6);
+	
+	SECTION("Is not changed by new overrides") {
+		container.emplace<Concrete1Service>();
+		CHECK(view.size() == 3);
+		CHECK(container.service<kgr::override_view_service<BaseService>>().size() == 3);
+		CHECK(container.service<kgr::override_view_service<AbstractService>>().size() == 1);
+	}
+}
+
+TEST_CASE("The override view holds services yielding non-trivial types", "[service_range, virtual]") {
+	using namespace service_range_test;
+	kgr::container container;
+	
+	auto const empty = container.service<kgr::override_view_service<ShapeService>>();
+	CHECK(empty.empty());
+	
+	container.emplace<TriangleService>();
+	container.emplace<SquareService>();
+	
+	auto const view = container.service<kgr::override_view_service<ShapeService>>();
+	
+	REQUIRE(view.size() == 2);
+	CHECK(view[0]->sides() == 3);
+	CHECK(view[1]->sides() == 4);
+	CHECK(view[0] == container.service<TriangleService>());
+	CHECK((view.end() - view.begin()) == 2);
+	CHECK(view.begin()[1].use_count() > 1);
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+
+namespace static_container_test {
+
+static int constructed_count = 0;
+
+struct Dependency {
+	Dependency() {
+		constructed_count++;
+	}
+};
+
+struct DependencyService : kgr::single_service<Dependency> {};
+
+struct Service {
+	Dependency& dependency;
+};
+
+struct ServiceDefinition : kgr::single_service<Service, kgr::dependency<DependencyService>> {};
+
+struct Unlisted {
+	Dependency& dependency;
+};
+
+struct UnlistedService : kgr::single_service<Unlisted, kgr::dependency<DependencyService>> {};
+
+struct Base {
+	virtual ~Base() = default;
+	virtual auto value() const -> int { return 1; }
+};
+
+struct Derived : Base {
+	auto value() const -> int override { return 2; }
+};
+
+struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+struct DerivedService : kgr::single_service<Derived>, kgr::overrides<BaseService> {};
+
+struct Counter {
+	int value = 0;
+};
+
+struct CounterService : kgr::single_service<Counter> {};
+
+auto service_map(Counter const&) -> CounterService;
+
+using container_t = kgr::static_container<DependencyService, ServiceDefinition, BaseService, CounterService>;
+
+}
+
+TEST_CASE("The static container returns services from their slots", "[static_container]") {
+	using namespace static_container_test;
+	constructed_count = 0;
+	
+	container_t container;
+	
+	auto& service = container.service<ServiceDefinition>();
+	
+	REQUIRE(&service == &container.service<ServiceDefinition>());
+	REQUIRE(&service.dependency == &container.service<DependencyService>());
+	REQUIRE(container.contains<DependencyService>());
+	REQUIRE(constructed_count == 1);
+	
+	SECTION("Unlisted services share the listed ones") {
+		auto& unlisted = container.service<UnlistedService>();
+		
+		REQUIRE(&unlisted == &container.service<UnlistedService>());
+		REQUIRE(&unlisted.dependency == &service.dependency);
+		REQUIRE(constructed_count == 1);
+	}
+	
+	SECTION("Clearing empties the slots") {
+		container.clear();
+		
+		REQUIRE_FALSE(container.contains<DependencyService>());
+		container.service<DependencyService>();
+		REQUIRE(constructed_count == 2);
+	}
+	
+	SECTION("Forks see the services of the slots") {
+		auto fork = container.fork();
+		
+		REQUIRE(&fork.service<ServiceDefinition>() == &service);
+	}
+}
+
+TEST_CASE("The static container updates slots when services change", "[static_container]") {
+	using namespace static_container_test;
+	
+	container_t container;
+	
+	SECTION("Replacing a listed service") {
+		container.service<CounterService>().value = 1;
+		container.replace<CounterService>();
+		
+		REQUIRE(container.service<CounterService>().value == 0);
+	}
+	
+	SECTION("Overriding a listed polymorphic service") {
+		REQUIRE(container.service<BaseService>().value() == 1);
+		REQUIRE(container.emplace<DerivedService>());
+		REQUIRE(container.service<BaseService>().value() == 2);
+	}
+	
+	SECTION("Overriding through an unlisted service") {
+		REQUIRE(container.service<BaseService>().value() == 1);
+		container.service<DerivedService>();
+		REQUIRE(container.service<BaseService>().value() == 2);
+	}
+	
+	SECTION("Invoking with listed and unlisted services") {
+		container.invoke<CounterService, UnlistedService>([](Counter& counter, Unlisted&) {
+			counter.value = 3;
+		});
+		
+		container.invoke([](Counter& counter) {
+			REQUIRE(counter.value == 3);
+		});
+	}
+}
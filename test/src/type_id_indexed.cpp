@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <kangaru/kangaru.hpp>
+
+#include <vector>
+
+namespace type_id_indexed_test {
+
+struct First {};
+struct Second {};
+
+struct Service {
+	int value = 0;
+};
+
+struct Definition1 : kgr::single_service<Service> {};
+struct Definition2 : kgr::single_service<Service> {};
+
+struct Base {
+	virtual ~Base() = default;
+	virtual auto value() const -> int { return 1; }
+};
+
+struct Derived : Base {
+	auto value() const -> int override { return 2; }
+};
+
+struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+struct DerivedService : kgr::single_service<Derived>, kgr::overrides<BaseService> {};
+
+} // namespace type_id_indexed_test
+
+TEST_CASE("The indexed type ids are small and dense", "[type_id]") {
+	using namespace type_id_indexed_test;
+	
+	auto const first = kgr::type_id<First>();
+	auto const second = kgr::type_id<Second>();
+	
+	REQUIRE(first != kgr::type_id_t{});
+	REQUIRE(kgr::type_id<First>() == first);
+	REQUIRE(kgr::detail::type_id_index(second) == kgr::detail::type_id_index(first) + 1);
+	REQUIRE(kgr::detail::cache_index<Second>() == kgr::detail::type_id_index(second));
+}
+
+TEST_CASE("The indexed type ids keep the kind of service", "[type_id]") {
+	using namespace type_id_indexed_test;
+	
+	REQUIRE(kgr::detail::type_id_kind(kgr::type_id<First>()) == kgr::detail::service_kind_t::normal);
+	REQUIRE(kgr::detail::type_id_kind(kgr::type_id<kgr::detail::override_storage_service>()) == kgr::detail::service_kind_t::override_storage);
+	REQUIRE(kgr::detail::type_id_kind(kgr::type_id<kgr::detail::index_storage<BaseService>>()) == kgr::detail::service_kind_t::index_storage);
+}
+
+TEST_CASE("The container works with indexed type ids", "[type_id]") {
+	using namespace type_id_indexed_test;
+	
+	kgr::container container;
+	container.emplace<DerivedService>();
+	
+	auto& service = container.service<Definition1>();
+	auto fork = container.fork<kgr::except<Definition1>>();
+	
+	REQUIRE(&fork.service<Definition1>() != &service);
+	REQUIRE(fork.service<BaseService>().value() == 2);
+	
+	auto frozen = container.freeze();
+	
+	REQUIRE(&frozen.service<Definition1>() == &service);
+	REQUIRE(frozen.service<BaseService>().value() == 2);
+	REQUIRE_FALSE(frozen.contains<Definition2>());
+}
+
+TEST_CASE("The frozen table only places ids by index when they are dense", "[type_id]") {
+	std::vector<int> values(64);
+	kgr::detail::service_table dense;
+	kgr::detail::service_table sparse;
+	
+	for (std::size_t i = 0 ; i < values.size() ; ++i) {
+		auto const storage = kgr::detail::service_storage{kgr::detail::override_index, static_cast<void*>(&values[i])};
+		
+		dense.emplace(kgr::type_id_t{i + 1}, storage);
+		sparse.emplace(kgr::type_id_t{(i + 1) * 1000}, storage);
+	}
+	
+	kgr::detail::frozen_service_table const dense_table{dense};
+	kgr::detail::frozen_service_table const sparse_table{sparse};
+	
+	REQUIRE(sparse_table.memory_usage() < 1000 * sizeof(kgr::detail::service_storage));
+	
+	for (std::size_t i = 0 ; i < values.size() ; ++i) {
+		REQUIRE(&dense_table.find(kgr::type_id_t{i + 1})->service<int>() == &values[i]);
+		REQUIRE(&sparse_table.find(kgr::type_id_t{(i + 1) * 1000})->service<int>() == &values[i]);
+		REQUIRE_FALSE(dense_table.find(kgr::type_id_t{(i + 1) * 1000 + 1}));
+		REQUIRE_FALSE(sparse_table.find(kgr::type_id_t{i + 1}));
+	}
+}
@@ -388,3 +388,89 @@ TEST_CASE("A service can depend on a abstract service", "[virtual]") {
 	
 	REQUIRE(&container.service<UseService>().a == &container.service<AbstractService>());
 }
+
+TEST_CASE("Overrides forwarded when inserted are replaced by new overrides", "[virtual]") {
+	static int forward_called;
+	forward_called = 0;
+	
+	kgr::container container;
+	
+	struct Interface {
+		virtual ~Interface() = default;
+		virtual auto value() const -> int = 0;
+	};
+	
+	struct Padding {
+		virtual ~Padding() = default;
+		int padding = 0;
+	};
+	
+	struct First : Interface {
+		auto value() const -> int override { return 1; }
+	};
+	
+	struct Second : Padding, Interface {
+		auto value() const -> int override { return 2; }
+	};
+	
+	struct InterfaceService : kgr::abstract_service<Interface> {};
+	struct FirstService : kgr::single_service<First>, kgr::overrides<InterfaceService> {};
+	struct SecondService : kgr::single_service<Second>, kgr::overrides<InterfaceService> {};
+	
+	struct CountingService : kgr::single_service<First>, kgr::overrides<InterfaceService> {
+		auto forward() -> First& {
+			forward_called++;
+			return single_service::forward();
+		}
+	};
+	
+	REQUIRE(kgr::detail::has_single_service_forward<FirstService>::value);
+	REQUIRE_FALSE(kgr::detail::has_single_service_forward<CountingService>::value);
+	
+	container.emplace<FirstService>();
+	REQUIRE(&container.service<InterfaceService>() == &container.service<FirstService>());
+	REQUIRE(container.service<InterfaceService>().value() == 1);
+	
+	container.emplace<SecondService>();
+	REQUIRE(&container.service<InterfaceService>() == static_cast<Interface*>(&container.service<SecondService>()));
+	REQUIRE(container.service<InterfaceService>().value() == 2);
+	
+	auto fork = container.fork();
+	REQUIRE(fork.service<InterfaceService>().value() == 2);
+	
+	fork.emplace<CountingService>();
+	REQUIRE(fork.service<InterfaceService>().value() == 1);
+	REQUIRE(fork.service<InterfaceService>().value() == 1);
+	REQUIRE(forward_called == 2);
+	REQUIRE(container.service<InterfaceService>().value() == 2);
+}
+
+TEST_CASE("Polymorphic singles forwarded when inserted are the same instance", "[virtual]") {
+	kgr::container container;
+	
+	struct Base {
+		virtual ~Base() = default;
+		int value = 1;
+	};
+	
+	struct Configured {
+		void configure(Base& b) { base = &b; }
+		Base* base = nullptr;
+	};
+	
+	struct BaseService : kgr::single_service<Base>, kgr::polymorphic {};
+	struct ConfiguredService : kgr::single_service<Configured>, kgr::autocall<
+		kgr::invoke<kgr::method<decltype(&Configured::configure), &Configured::configure>, BaseService>
+	> {};
+	
+	auto& base = container.service<BaseService>();
+	base.value = 2;
+	
+	REQUIRE(&container.service<BaseService>() == &base);
+	REQUIRE(container.service<BaseService>().value == 2);
+	REQUIRE(container.service<ConfiguredService>().base == &base);
+	REQUIRE(&container.service<kgr::override_view_service<BaseService>>()[0] == &base);
+	
+	auto fork = container.fork();
+	REQUIRE(&fork.service<BaseService>() == &base);
+}